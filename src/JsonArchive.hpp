@@ -0,0 +1,210 @@
+#ifndef CPP_JSON_PARSER_JSONARCHIVE_HPP_
+#define CPP_JSON_PARSER_JSONARCHIVE_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MappedFile.hpp"
+
+// A packed content archive, many JSON files bundled into one file so startup costs a single open and mmap.
+// Layout, all integers little-endian:
+//   Header  | magic "JSONPAK1" | uint32 version | uint32 entry count | uint64 index offset | uint64 index size |
+//   Data    | each entry's raw JSON text, starting on a kDataAlignment boundary and followed by a null terminator |
+//   Index   | per entry: uint32 name length | uint32 reserved | uint64 data offset | uint64 data size | name, padded to 8 bytes |
+class JsonArchive {
+public:
+	static const uint32_t kVersion = 1;
+	static const size_t kHeaderSize = 32;
+	static const size_t kDataAlignment = 16;
+
+	// Constructors & Deconstructors
+	JsonArchive(void) {}
+	JsonArchive(const std::string& archiveName) {
+		Open(archiveName);
+	}
+	JsonArchive(const JsonArchive&) = delete;
+	JsonArchive& operator=(const JsonArchive&) = delete;
+
+	// Maps the archive and reads its index, entries are only touched when they are loaded
+	bool Open(const std::string& archiveName) {
+		Close();
+		this->archiveName = archiveName;
+		if (!mappedArchive.Open(archiveName)) {
+			return false;
+		}
+		const char* archiveData = mappedArchive.Data();
+		const size_t archiveSize = mappedArchive.Size();
+		if (archiveSize < kHeaderSize || std::memcmp(archiveData, Magic(), 8) != 0 || ReadUint32(archiveData + 8) != kVersion) {
+			std::cout << "JsonArchive.hpp >>>> File: " << archiveName << " is not a version " << (int)kVersion << " content archive" << std::endl;
+			Close();
+			return false;
+		}
+		const uint32_t entryCount = ReadUint32(archiveData + 12);
+		const uint64_t indexOffset = ReadUint64(archiveData + 16);
+		const uint64_t indexSize = ReadUint64(archiveData + 24);
+		if (indexOffset > archiveSize || indexSize > archiveSize - indexOffset) {
+			std::cout << "JsonArchive.hpp >>>> File: " << archiveName << " has a corrupt index" << std::endl;
+			Close();
+			return false;
+		}
+
+		// Read the index into our lookup table
+		const char* indexPosition = archiveData + indexOffset;
+		const char* indexEnd = indexPosition + indexSize;
+		entries.reserve(entryCount);
+		for (uint32_t i = 0; i < entryCount; i++) {
+			if (indexEnd - indexPosition < 24) {
+				std::cout << "JsonArchive.hpp >>>> File: " << archiveName << " has a truncated index" << std::endl;
+				Close();
+				return false;
+			}
+			const uint32_t nameLength = ReadUint32(indexPosition);
+			Entry entry;
+			entry.offset = ReadUint64(indexPosition + 8);
+			entry.size = ReadUint64(indexPosition + 16);
+			indexPosition += 24;
+			if ((size_t)(indexEnd - indexPosition) < nameLength || entry.offset > archiveSize || entry.size > archiveSize - entry.offset) {
+				std::cout << "JsonArchive.hpp >>>> File: " << archiveName << " has a corrupt index entry" << std::endl;
+				Close();
+				return false;
+			}
+			entries[std::string(indexPosition, nameLength)] = entry;
+			indexPosition += PaddedSize(nameLength, 8);
+		}
+		std::cout << "JsonArchive.hpp >>>> Archive: " << archiveName << " was opened with " << entryCount << " entries" << std::endl;
+		return true;
+	}
+	void Close(void) {
+		entries.clear();
+		mappedArchive.Close();
+	}
+
+	// Accessors
+	const bool IsOpen(void) const {
+		return mappedArchive.IsOpen();
+	}
+	const std::string& GetArchiveName(void) const {
+		return archiveName;
+	}
+	const size_t NumberOfEntries(void) const {
+		return entries.size();
+	}
+	const bool HasEntry(const std::string& entryName) const {
+		return entries.find(entryName) != entries.end();
+	}
+	// Points entryData at the entry's JSON text inside the mapping, which stays valid until the archive is closed
+	bool Find(const std::string& entryName, const char*& entryData, size_t& entrySize) const {
+		std::unordered_map<std::string, Entry>::const_iterator entry = entries.find(entryName);
+		if (entry == entries.end()) {
+			return false;
+		}
+		entryData = mappedArchive.Data() + entry->second.offset;
+		entrySize = (size_t)entry->second.size;
+		return true;
+	}
+	std::vector<std::string> GetEntryNames(void) const {
+		std::vector<std::string> entryNames;
+		entryNames.reserve(entries.size());
+		for (const auto& entry : entries) {
+			entryNames.push_back(entry.first);
+		}
+		return entryNames;
+	}
+
+	// Writes an archive containing the given (name, JSON text) pairs, used by the content packer
+	static bool Write(const std::string& archiveName, const std::vector<std::pair<std::string, std::string>>& entriesToWrite) {
+		std::ofstream outFileStream(archiveName, std::ios::binary | std::ios::trunc);
+		if (!outFileStream.is_open()) {
+			std::cout << "JsonArchive.hpp >>>> File: " << archiveName << " could not be opened for writing" << std::endl;
+			return false;
+		}
+
+		// Data section first, remembering where each entry landed for the index
+		std::vector<Entry> writtenEntries;
+		uint64_t writePosition = kHeaderSize;
+		std::string archiveBody = "";
+		for (const auto& entryToWrite : entriesToWrite) {
+			const uint64_t alignedPosition = PaddedSize(writePosition, kDataAlignment);
+			archiveBody.append((size_t)(alignedPosition - writePosition), '\0');
+			Entry entry;
+			entry.offset = alignedPosition;
+			entry.size = entryToWrite.second.size();
+			writtenEntries.push_back(entry);
+			archiveBody.append(entryToWrite.second);
+			archiveBody.push_back('\0');
+			writePosition = alignedPosition + entry.size + 1;
+		}
+
+		// Then the index
+		const uint64_t indexOffset = PaddedSize(writePosition, 8);
+		archiveBody.append((size_t)(indexOffset - writePosition), '\0');
+		std::string index = "";
+		const size_t numberOfEntries = entriesToWrite.size();
+		for (size_t i = 0; i < numberOfEntries; i++) {
+			const std::string& entryName = entriesToWrite[i].first;
+			AppendUint32(index, (uint32_t)entryName.size());
+			AppendUint32(index, 0);
+			AppendUint64(index, writtenEntries[i].offset);
+			AppendUint64(index, writtenEntries[i].size);
+			index.append(entryName);
+			index.append(PaddedSize(entryName.size(), 8) - entryName.size(), '\0');
+		}
+
+		std::string header(Magic(), 8);
+		AppendUint32(header, kVersion);
+		AppendUint32(header, (uint32_t)numberOfEntries);
+		AppendUint64(header, indexOffset);
+		AppendUint64(header, index.size());
+
+		outFileStream.write(header.data(), header.size());
+		outFileStream.write(archiveBody.data(), archiveBody.size());
+		outFileStream.write(index.data(), index.size());
+		if (!outFileStream.good()) {
+			std::cout << "JsonArchive.hpp >>>> File: " << archiveName << " could not be written" << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+private:
+	struct Entry {
+		uint64_t offset = 0;
+		uint64_t size = 0;
+	};
+
+	std::string archiveName = "";
+	MappedFile mappedArchive;
+	std::unordered_map<std::string, Entry> entries;
+
+	static const char* Magic(void) {
+		return "JSONPAK1";
+	}
+	static uint64_t PaddedSize(uint64_t size, uint64_t alignment) {
+		return (size + alignment - 1) / alignment * alignment;
+	}
+
+	// Little-endian encoding, written byte by byte so the format doesn't depend on the host.
+	// These take their arguments by value so the static constants above are never odr-used
+	static uint32_t ReadUint32(const char* data) {
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+		return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+	}
+	static uint64_t ReadUint64(const char* data) {
+		return (uint64_t)ReadUint32(data) | ((uint64_t)ReadUint32(data + 4) << 32);
+	}
+	static void AppendUint32(std::string& output, uint32_t value) {
+		for (int i = 0; i < 4; i++) {
+			output.push_back((char)((value >> (i * 8)) & 0xFF));
+		}
+	}
+	static void AppendUint64(std::string& output, uint64_t value) {
+		AppendUint32(output, (uint32_t)(value & 0xFFFFFFFF));
+		AppendUint32(output, (uint32_t)(value >> 32));
+	}
+};
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef CPP_JSON_PARSER_JSONBASE64_HPP_
+#define CPP_JSON_PARSER_JSONBASE64_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Standard (RFC 4648) base64 with '=' padding, used for packed numeric arrays.
+// Decoding works on whole 4 character blocks through a lookup table, invalid characters are checked for once per call rather than once per character
+class JsonBase64 {
+public:
+	static void Encode(const unsigned char* data, const size_t& size, std::string& output) {
+		static const char encodingTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		const size_t outputStart = output.size();
+		output.resize(outputStart + (size + 2) / 3 * 4);
+		char* outputPosition = &output[outputStart];
+		size_t i = 0;
+		for (; i + 3 <= size; i += 3) {
+			const uint32_t block = ((uint32_t)data[i] << 16) | ((uint32_t)data[i + 1] << 8) | (uint32_t)data[i + 2];
+			outputPosition[0] = encodingTable[(block >> 18) & 0x3F];
+			outputPosition[1] = encodingTable[(block >> 12) & 0x3F];
+			outputPosition[2] = encodingTable[(block >> 6) & 0x3F];
+			outputPosition[3] = encodingTable[block & 0x3F];
+			outputPosition += 4;
+		}
+		// Pad out the final partial block
+		const size_t remaining = size - i;
+		if (remaining > 0) {
+			const uint32_t block = ((uint32_t)data[i] << 16) | ((remaining == 2) ? ((uint32_t)data[i + 1] << 8) : 0);
+			outputPosition[0] = encodingTable[(block >> 18) & 0x3F];
+			outputPosition[1] = encodingTable[(block >> 12) & 0x3F];
+			outputPosition[2] = (remaining == 2) ? encodingTable[(block >> 6) & 0x3F] : '=';
+			outputPosition[3] = '=';
+		}
+	}
+
+	// Returns false if the input isn't valid base64, output is left holding whatever was decoded
+	static bool Decode(const char* data, const size_t& size, std::vector<unsigned char>& output) {
+		if (size % 4 != 0) {
+			return false;
+		}
+		output.clear();
+		if (size == 0) {
+			return true;
+		}
+		const unsigned char* decodingTable = DecodingTable();
+		const unsigned char* input = reinterpret_cast<const unsigned char*>(data);
+		size_t padding = 0;
+		if (input[size - 1] == '=') {
+			padding = (input[size - 2] == '=') ? 2 : 1;
+		}
+		output.resize(size / 4 * 3);
+		unsigned char* outputPosition = output.data();
+
+		// Every block but the last can't contain padding, so decode them without any checks inside the loop
+		const size_t fullBlocksSize = size - 4;
+		unsigned char invalidBits = 0;
+		for (size_t i = 0; i < fullBlocksSize; i += 4) {
+			const unsigned char a = decodingTable[input[i]];
+			const unsigned char b = decodingTable[input[i + 1]];
+			const unsigned char c = decodingTable[input[i + 2]];
+			const unsigned char d = decodingTable[input[i + 3]];
+			invalidBits |= a | b | c | d;
+			const uint32_t block = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) | (uint32_t)d;
+			outputPosition[0] = (unsigned char)(block >> 16);
+			outputPosition[1] = (unsigned char)(block >> 8);
+			outputPosition[2] = (unsigned char)block;
+			outputPosition += 3;
+		}
+		if (invalidBits & kInvalid) {
+			return false;
+		}
+
+		// Final block, padding characters decode as zero
+		unsigned char lastBlock[4];
+		for (size_t i = 0; i < 4; i++) {
+			const unsigned char inputChar = input[fullBlocksSize + i];
+			lastBlock[i] = (inputChar == '=' && i >= 4 - padding) ? 0 : decodingTable[inputChar];
+			if (lastBlock[i] & kInvalid) {
+				return false;
+			}
+		}
+		const uint32_t block = ((uint32_t)lastBlock[0] << 18) | ((uint32_t)lastBlock[1] << 12) | ((uint32_t)lastBlock[2] << 6) | (uint32_t)lastBlock[3];
+		outputPosition[0] = (unsigned char)(block >> 16);
+		outputPosition[1] = (unsigned char)(block >> 8);
+		outputPosition[2] = (unsigned char)block;
+		output.resize(output.size() - padding);
+		return true;
+	}
+
+private:
+	static const unsigned char kInvalid = 0x80;
+
+	// 256 entry lookup from character to its 6 bit value, anything outside the alphabet has the kInvalid bit set
+	static const unsigned char* DecodingTable(void) {
+		static unsigned char decodingTable[256];
+		static bool isBuilt = BuildDecodingTable(decodingTable);
+		(void)isBuilt;
+		return decodingTable;
+	}
+	static bool BuildDecodingTable(unsigned char* decodingTable) {
+		const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		for (size_t i = 0; i < 256; i++) {
+			decodingTable[i] = kInvalid;
+		}
+		for (unsigned char i = 0; i < 64; i++) {
+			decodingTable[(unsigned char)alphabet[i]] = i;
+		}
+		return true;
+	}
+};
+
+#endif
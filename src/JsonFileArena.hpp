@@ -0,0 +1,225 @@
+#ifndef CPP_JSON_PARSER_JSONFILEARENA_HPP_
+#define CPP_JSON_PARSER_JSONFILEARENA_HPP_
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "rapidjson/document.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <winioctl.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-write mapping of a sparse scratch file used as the memory of an out-of-core document, pages are only backed by disk blocks once written.
+// The scratch file is deleted as soon as it is mapped (on close on Windows), so nothing is left behind if the process dies.
+// Pages are released back to the file in bulk once roughly residentBudget bytes have been touched, and the OS pages them back in when they are next read
+class JsonFileArena {
+public:
+	// Constructors & Deconstructors
+	JsonFileArena(void) {}
+	~JsonFileArena() {
+		Close();
+	}
+	JsonFileArena(const JsonFileArena&) = delete;
+	JsonFileArena& operator=(const JsonFileArena&) = delete;
+
+	bool Create(const std::string& scratchFileName, const size_t& capacity, const size_t& residentBudget) {
+		Close();
+		this->residentBudget = residentBudget;
+#ifdef _WIN32
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo(&systemInfo);
+		pageSize = systemInfo.dwPageSize;
+		fileHandle = CreateFileA(scratchFileName.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE) {
+			std::cout << "JsonFileArena.hpp >>>> File: " << scratchFileName << " could not be created" << std::endl;
+			return false;
+		}
+		// Without this the mapping would allocate the whole capacity on disk up front
+		DWORD bytesReturned = 0;
+		DeviceIoControl(fileHandle, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &bytesReturned, nullptr);
+		const uint64_t mappingSize = capacity;
+		mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READWRITE, (DWORD)(mappingSize >> 32), (DWORD)(mappingSize & 0xFFFFFFFF), nullptr);
+		if (mappingHandle == nullptr) {
+			std::cout << "JsonFileArena.hpp >>>> File: " << scratchFileName << " could not be sized" << std::endl;
+			Close();
+			return false;
+		}
+		mappedData = static_cast<char*>(MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, capacity));
+#else
+		pageSize = (size_t)sysconf(_SC_PAGESIZE);
+		fileDescriptor = open(scratchFileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+		if (fileDescriptor < 0) {
+			std::cout << "JsonFileArena.hpp >>>> File: " << scratchFileName << " could not be created" << std::endl;
+			return false;
+		}
+		unlink(scratchFileName.c_str());	// The open descriptor and the mapping keep the file alive
+		if (ftruncate(fileDescriptor, (off_t)capacity) != 0) {
+			std::cout << "JsonFileArena.hpp >>>> File: " << scratchFileName << " could not be sized" << std::endl;
+			Close();
+			return false;
+		}
+		void* mapping = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+		mappedData = (mapping != MAP_FAILED) ? static_cast<char*>(mapping) : nullptr;
+#endif
+		if (mappedData == nullptr) {
+			std::cout << "JsonFileArena.hpp >>>> File: " << scratchFileName << " could not be mapped" << std::endl;
+			Close();
+			return false;
+		}
+		mappedSize = capacity;
+		return true;
+	}
+	void Close(void) {
+#ifdef _WIN32
+		if (mappedData != nullptr) {
+			UnmapViewOfFile(mappedData);
+		}
+		if (mappingHandle != nullptr) {
+			CloseHandle(mappingHandle);
+			mappingHandle = nullptr;
+		}
+		if (fileHandle != INVALID_HANDLE_VALUE) {
+			CloseHandle(fileHandle);
+			fileHandle = INVALID_HANDLE_VALUE;
+		}
+#else
+		if (mappedData != nullptr) {
+			munmap(mappedData, mappedSize);
+		}
+		if (fileDescriptor >= 0) {
+			close(fileDescriptor);
+			fileDescriptor = -1;
+		}
+#endif
+		mappedData = nullptr;
+		mappedSize = 0;
+		touchedBytes = 0;
+		lastUsedBytes = 0;
+	}
+
+	// Adds to the estimate of how much has been paged in since the last release, releasing everything once it passes the budget.
+	// usedBytes is how much of the arena holds the document, the estimate grows by whichever is larger of streamedBytes and the growth in usedBytes
+	void NoteTouched(const size_t& streamedBytes, const size_t& usedBytes) {
+		const size_t grownBytes = (usedBytes > lastUsedBytes) ? usedBytes - lastUsedBytes : 0;
+		lastUsedBytes = usedBytes;
+		touchedBytes += (grownBytes > streamedBytes) ? grownBytes : streamedBytes;
+		if (touchedBytes >= residentBudget) {
+			Release(usedBytes);
+		}
+	}
+	// Drops the first usedBytes of the arena from this process's resident memory, written pages are kept in the file
+	void Release(const size_t& usedBytes) {
+		touchedBytes = 0;
+		lastUsedBytes = usedBytes;
+		if (mappedData == nullptr || usedBytes == 0) {
+			return;
+		}
+		const size_t releaseSize = ((usedBytes < mappedSize ? usedBytes : mappedSize) + pageSize - 1) / pageSize * pageSize;
+#ifdef _WIN32
+		FlushViewOfFile(mappedData, releaseSize);
+		VirtualUnlock(mappedData, releaseSize);		// Fails as the pages were never locked, but still removes them from the working set
+#else
+		msync(mappedData, releaseSize, MS_ASYNC);
+		madvise(mappedData, releaseSize, MADV_DONTNEED);
+#endif
+	}
+
+	// Accessors
+	const bool IsOpen(void) const {
+		return mappedData != nullptr;
+	}
+	char* Data(void) const {
+		return mappedData;
+	}
+	const size_t Capacity(void) const {
+		return mappedSize;
+	}
+	const size_t ResidentBudget(void) const {
+		return residentBudget;
+	}
+
+private:
+#ifdef _WIN32
+	HANDLE fileHandle = INVALID_HANDLE_VALUE;
+	HANDLE mappingHandle = nullptr;
+#else
+	int fileDescriptor = -1;
+#endif
+	char* mappedData = nullptr;
+	size_t mappedSize = 0;
+	size_t pageSize = 4096;
+	size_t residentBudget = 0;
+	size_t touchedBytes = 0;
+	size_t lastUsedBytes = 0;
+};
+
+// Stream wrapper which keeps an arena-backed document under its resident budget while it is parsed from, or written to, Stream.
+// Every kCheckInterval bytes the arena is told how far the document has grown, so long loads and saves release pages as they go.
+// A parse can also pass the arena holding the parser's stack, which is only charged for how far the stack has grown
+template<typename Stream> class JsonArenaBudgetStream {
+public:
+	typedef typename Stream::Ch Ch;
+	static const size_t kCheckInterval = 1 << 20;
+
+	JsonArenaBudgetStream(Stream& stream, JsonFileArena& arena, const rapidjson::MemoryPoolAllocator<>& allocator, JsonFileArena* stackArena = nullptr, const rapidjson::MemoryPoolAllocator<>* stackAllocator = nullptr) : stream(stream), arena(arena), allocator(allocator), stackArena(stackArena), stackAllocator(stackAllocator) {}
+
+	// Input
+	Ch Peek(void) const {
+		return stream.Peek();
+	}
+	Ch Take(void) {
+		CountByte();
+		return stream.Take();
+	}
+	size_t Tell(void) const {
+		return stream.Tell();
+	}
+	// Output
+	void Put(Ch outputChar) {
+		CountByte();
+		stream.Put(outputChar);
+	}
+	void Flush(void) {
+		stream.Flush();
+	}
+	Ch* PutBegin(void) {
+		return stream.PutBegin();
+	}
+	size_t PutEnd(Ch* begin) {
+		return stream.PutEnd(begin);
+	}
+
+private:
+	Stream& stream;
+	JsonFileArena& arena;
+	const rapidjson::MemoryPoolAllocator<>& allocator;
+	JsonFileArena* stackArena;
+	const rapidjson::MemoryPoolAllocator<>* stackAllocator;
+	size_t bytesSinceCheck = 0;
+
+	void CountByte(void) {
+		if (++bytesSinceCheck == kCheckInterval) {
+			bytesSinceCheck = 0;
+			arena.NoteTouched(kCheckInterval, allocator.Size());
+			if (stackArena != nullptr && stackAllocator != nullptr) {
+				stackArena->NoteTouched(0, stackAllocator->Size());
+			}
+		}
+	}
+};
+template<typename Stream> const size_t JsonArenaBudgetStream<Stream>::kCheckInterval;	// NoteTouched() takes it by reference, so it needs a definition
+
+#endif
@@ -0,0 +1,306 @@
+#ifndef CPP_JSON_PARSER_JSONFILEREGISTRY_HPP_
+#define CPP_JSON_PARSER_JSONFILEREGISTRY_HPP_
+
+#include <cstdlib>
+#include <climits>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "JsonParser.hpp"
+
+class JsonFileRegistry;
+
+// Read-only view of a registry document which keeps it loaded for as long as the view is held, use this when reading JsonStringViews or ArrayViews.
+// Pinned documents are skipped by eviction, so hold pins for as short a time as possible
+class JsonFilePin {
+public:
+	JsonFilePin(const std::shared_ptr<JsonFile>& document) : document(document) {}
+
+	// Get functions, the read-only half of the JsonFile API
+	template<typename T> inline T Get(const std::string& objectName) {
+		return document->Get<T>(objectName);
+	}
+	template<typename T> inline std::vector<T> GetVector(const std::string& objectName) {
+		return document->GetVector<T>(objectName);
+	}
+	template<typename T> inline std::vector<T> Query(const std::string& queryPath) {
+		return document->Query<T>(queryPath);
+	}
+	template<typename T> inline JsonFile::ArrayView<T> GetArrayView(const std::string& objectName) {
+		return document->GetArrayView<T>(objectName);
+	}
+	inline JsonStringView GetView(const std::string& objectName) {
+		return document->GetView(objectName);
+	}
+	inline std::vector<JsonStringView> GetViewVector(const std::string& objectName) {
+		return document->GetViewVector(objectName);
+	}
+	inline const size_t SizeOfObjectArray(const std::string& objectName) {
+		return document->SizeOfObjectArray(objectName);
+	}
+	inline const bool IsLoaded(void) {
+		return document->IsLoaded();
+	}
+
+private:
+	std::shared_ptr<JsonFile> document;	// Shared with every other handle to the same file, which is why only reads are exposed
+};
+
+// Shared, reference counted read handle to a document owned by the JsonFileRegistry, the document is dropped once its last handle goes.
+// The document may be evicted between calls, in which case the next call transparently re-loads it.
+class JsonFileHandle {
+public:
+	JsonFileHandle(void) : registry(nullptr) {}
+
+	// Get functions, these mirror the read-only half of the JsonFile API
+	template<typename T> inline T Get(const std::string& objectName);
+	template<typename T> inline std::vector<T> GetVector(const std::string& objectName);
+	template<typename T> inline std::vector<T> Query(const std::string& queryPath);
+	inline const size_t SizeOfObjectArray(const std::string& objectName);
+	inline const bool IsLoaded(void);
+
+	// Pins the document in memory for as long as the returned view is held
+	inline JsonFilePin Pin(void);
+
+	const bool IsValid(void) const {
+		return entry != nullptr;
+	}
+	const std::string& GetFileName(void) const;
+
+private:
+	friend class JsonFileRegistry;
+	struct Entry;
+	JsonFileHandle(JsonFileRegistry* registry, const std::shared_ptr<Entry>& entry) : registry(registry), entry(entry) {}
+
+	JsonFileRegistry* registry;
+	std::shared_ptr<Entry> entry;	// Shared by every handle to the file, the registry only keeps a raw pointer so the last handle's release frees the entry
+
+	// The entry's document, re-loaded if it was evicted
+	inline std::shared_ptr<JsonFile> Document(void);
+};
+
+// Registry bookkeeping for a single canonical path
+struct JsonFileHandle::Entry {
+	std::string canonicalPath = "";
+	std::shared_ptr<JsonFile> document;
+	size_t memoryUsage = 0;
+	bool isResident = false;
+	bool isLoading = false;				// Set while a resolver parses the file without holding the registry lock
+	std::condition_variable loadFinished;	// Other resolvers of the same file wait on this rather than loading it a second time
+	std::weak_ptr<JsonFileHandle::Entry> handleShare;	// Lets Acquire() hand out another share of the handles' ownership
+	std::list<JsonFileHandle::Entry*>::iterator lruPosition;
+};
+
+// Process-wide registry which deduplicates JsonFiles by their canonical path and hands out shared read handles.
+// Loaded documents are kept in LRU order and evicted once the registry goes over its memory budget, skipping any that are pinned or mid-call.
+// Releasing the last handle to a file drops its document and forgets the file, a later Acquire() starts afresh
+class JsonFileRegistry {
+public:
+	static JsonFileRegistry& Instance(void) {
+		static JsonFileRegistry registry;
+		return registry;
+	}
+
+	// Returns a handle to fileName's document, loading it if no other subsystem has yet
+	JsonFileHandle Acquire(const std::string& fileName) {
+		const std::string canonicalPath = CanonicalPath(fileName);
+		std::lock_guard<std::mutex> lock(registryMutex);
+		std::unordered_map<std::string, JsonFileHandle::Entry*>::iterator existing = entries.find(canonicalPath);
+		if (existing != entries.end()) {
+			std::shared_ptr<JsonFileHandle::Entry> existingEntry = existing->second->handleShare.lock();
+			// An expired share means the last handle is being released right now, that release drops the old entry so start a new one
+			if (existingEntry != nullptr) {
+				return JsonFileHandle(this, existingEntry);
+			}
+		}
+		std::shared_ptr<JsonFileHandle::Entry> newEntry(new JsonFileHandle::Entry(), [this](JsonFileHandle::Entry* releasedEntry) {
+			Release(releasedEntry);
+		});
+		newEntry->canonicalPath = canonicalPath;
+		newEntry->handleShare = newEntry;
+		entries[canonicalPath] = newEntry.get();
+		return JsonFileHandle(this, newEntry);
+	}
+
+	// Budget for the summed MemoryUsage() of every loaded document, 0 means unlimited
+	void SetMemoryBudget(const size_t& budgetInBytes) {
+		std::lock_guard<std::mutex> lock(registryMutex);
+		memoryBudget = budgetInBytes;
+		EnforceMemoryBudget(nullptr);
+	}
+	const size_t GetMemoryBudget(void) {
+		std::lock_guard<std::mutex> lock(registryMutex);
+		return memoryBudget;
+	}
+	const size_t MemoryUsage(void) {
+		std::lock_guard<std::mutex> lock(registryMutex);
+		return memoryUsage;
+	}
+	const size_t NumberOfLoadedDocuments(void) {
+		std::lock_guard<std::mutex> lock(registryMutex);
+		return leastRecentlyUsed.size();
+	}
+
+	// Drops every loaded document that isn't pinned, handles stay valid and will re-load on their next access
+	void EvictAll(void) {
+		std::lock_guard<std::mutex> lock(registryMutex);
+		std::list<JsonFileHandle::Entry*>::iterator position = leastRecentlyUsed.begin();
+		while (position != leastRecentlyUsed.end()) {
+			JsonFileHandle::Entry* entry = *position++;
+			if (!IsPinned(*entry)) {
+				Evict(entry);
+			}
+		}
+	}
+
+private:
+	friend class JsonFileHandle;
+
+	JsonFileRegistry(void) {}
+	JsonFileRegistry(const JsonFileRegistry&) = delete;
+	JsonFileRegistry& operator=(const JsonFileRegistry&) = delete;
+
+	std::mutex registryMutex;
+	std::unordered_map<std::string, JsonFileHandle::Entry*> entries;	// Owned by the handles, see Release()
+	std::list<JsonFileHandle::Entry*> leastRecentlyUsed;	// Front is the most recently used loaded document
+	size_t memoryBudget = 0;
+	size_t memoryUsage = 0;
+
+	// Resolves the path so "content/engine.json" and "./content/engine.json" share a document, falls back to the given name
+	static std::string CanonicalPath(const std::string& fileName) {
+#ifdef _WIN32
+		char resolvedPath[_MAX_PATH];
+		if (_fullpath(resolvedPath, fileName.c_str(), _MAX_PATH) != nullptr) {
+			return resolvedPath;
+		}
+#else
+		char resolvedPath[PATH_MAX];
+		if (realpath(fileName.c_str(), resolvedPath) != nullptr) {
+			return resolvedPath;
+		}
+#endif
+		return fileName;
+	}
+
+	// Returns the entry's document, re-loading it if it was evicted, and marks it as the most recently used
+	std::shared_ptr<JsonFile> Resolve(JsonFileHandle::Entry& entry);
+	// Called when the last handle to an entry goes, forgets the file and frees the entry along with its document
+	void Release(JsonFileHandle::Entry* entry);
+
+	// Evicts least recently used documents until the budget is met, never evicting the entry being resolved or a pinned one
+	void EnforceMemoryBudget(const JsonFileHandle::Entry* keepEntry);
+	// Anyone holding the document besides the registry, evicting it then would free nothing and the next Resolve() would load a second copy
+	static bool IsPinned(const JsonFileHandle::Entry& entry) {
+		return entry.document.use_count() > 1;
+	}
+	void Evict(JsonFileHandle::Entry* entry);
+};
+
+inline std::shared_ptr<JsonFile> JsonFileRegistry::Resolve(JsonFileHandle::Entry& entry) {
+	std::unique_lock<std::mutex> lock(registryMutex);
+	entry.loadFinished.wait(lock, [&entry]() {
+		return !entry.isLoading;
+	});
+	if (entry.isResident) {
+		if (entry.lruPosition != leastRecentlyUsed.begin()) {
+			leastRecentlyUsed.splice(leastRecentlyUsed.begin(), leastRecentlyUsed, entry.lruPosition);
+		}
+		// Hand back our own reference, an eviction during the caller's access only drops the registry's share
+		return entry.document;
+	}
+
+	// Parse without the registry lock, so a large file doesn't hold up reads of documents which are already loaded
+	entry.isLoading = true;
+	lock.unlock();
+	std::shared_ptr<JsonFile> loadedDocument = std::make_shared<JsonFile>(entry.canonicalPath);
+	const size_t loadedMemoryUsage = loadedDocument->MemoryUsage();
+	lock.lock();
+	entry.document = loadedDocument;
+	entry.memoryUsage = loadedMemoryUsage;
+	entry.isResident = true;
+	entry.isLoading = false;
+	memoryUsage += entry.memoryUsage;
+	leastRecentlyUsed.push_front(&entry);
+	entry.lruPosition = leastRecentlyUsed.begin();
+	EnforceMemoryBudget(&entry);
+	entry.loadFinished.notify_all();
+	return loadedDocument;
+}
+inline void JsonFileRegistry::Release(JsonFileHandle::Entry* entry) {
+	std::shared_ptr<JsonFile> releasedDocument;	// Destroyed after the lock is released, freeing a large document can take a while
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+		if (entry->isResident) {
+			leastRecentlyUsed.erase(entry->lruPosition);
+			memoryUsage -= entry->memoryUsage;
+		}
+		// A racing Acquire() may have already registered a new entry under the same path
+		std::unordered_map<std::string, JsonFileHandle::Entry*>::iterator registered = entries.find(entry->canonicalPath);
+		if (registered != entries.end() && registered->second == entry) {
+			entries.erase(registered);
+		}
+		releasedDocument.swap(entry->document);
+	}
+	delete entry;
+}
+inline void JsonFileRegistry::EnforceMemoryBudget(const JsonFileHandle::Entry* keepEntry) {
+	if (memoryBudget == 0) {
+		return;
+	}
+	std::list<JsonFileHandle::Entry*>::iterator position = leastRecentlyUsed.end();
+	while (memoryUsage > memoryBudget && position != leastRecentlyUsed.begin()) {
+		--position;
+		JsonFileHandle::Entry* entry = *position;
+		if (entry != keepEntry && !IsPinned(*entry)) {
+			// Step onto the following entry, which has already been checked, so erasing this one doesn't invalidate the walk
+			++position;
+			Evict(entry);
+		}
+	}
+}
+inline void JsonFileRegistry::Evict(JsonFileHandle::Entry* entry) {
+	std::cout << "JsonFileRegistry.hpp >>>> Evicting: " << entry->canonicalPath << std::endl;
+	leastRecentlyUsed.erase(entry->lruPosition);
+	memoryUsage -= entry->memoryUsage;
+	entry->memoryUsage = 0;
+	entry->isResident = false;
+	entry->document.reset();
+}
+
+// JsonFileHandle functions, each one pins the document for the length of the call
+template<typename T> inline T JsonFileHandle::Get(const std::string& objectName) {
+	return Document()->Get<T>(objectName);
+}
+template<typename T> inline std::vector<T> JsonFileHandle::GetVector(const std::string& objectName) {
+	return Document()->GetVector<T>(objectName);
+}
+template<typename T> inline std::vector<T> JsonFileHandle::Query(const std::string& queryPath) {
+	return Document()->Query<T>(queryPath);
+}
+inline const size_t JsonFileHandle::SizeOfObjectArray(const std::string& objectName) {
+	return Document()->SizeOfObjectArray(objectName);
+}
+inline const bool JsonFileHandle::IsLoaded(void) {
+	return Document()->IsLoaded();
+}
+inline JsonFilePin JsonFileHandle::Pin(void) {
+	return JsonFilePin(Document());
+}
+inline std::shared_ptr<JsonFile> JsonFileHandle::Document(void) {
+	if (entry == nullptr) {
+		// Default constructed handles share one empty, unloaded file so calls report the usual not loaded errors
+		static const std::shared_ptr<JsonFile> emptyDocument = std::make_shared<JsonFile>();
+		return emptyDocument;
+	}
+	return registry->Resolve(*entry);
+}
+inline const std::string& JsonFileHandle::GetFileName(void) const {
+	static const std::string emptyFileName = "";
+	return (entry != nullptr) ? entry->canonicalPath : emptyFileName;
+}
+
+#endif
@@ -5,66 +5,139 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <iterator>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cctype>
+#include <map>
+#include <deque>
+#include <memory>
+#include <new>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <algorithm>
 #include "rapidjson/document.h"
 #include <rapidjson/istreamwrapper.h>
 #include <rapidjson/prettywriter.h>
 #include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/memorystream.h>
 #include <rapidjson/error/en.h>
+#include "JsonStringView.hpp"
+#include "JsonArchive.hpp"
+#include "JsonStringPool.hpp"
+#include "JsonBase64.hpp"
+#include "JsonSchema.hpp"
+#include "JsonSharedDocument.hpp"
+#include "JsonTrace.hpp"
+#include "JsonFileArena.hpp"
 
 class JsonFile {
 public:
 	// Constructors & Deconstructors
+	JsonFile::JsonFile() {
+		// Nothing is loaded, this lets load options such as EnableInterning() be set before calling Load()
+	}
 	JsonFile::JsonFile(const std::string& fileName) {
 		Load(fileName);
 	}
+	JsonFile::JsonFile(const JsonArchive& archive, const std::string& entryName) {
+		LoadFromArchive(archive, entryName);
+	}
 	JsonFile::~JsonFile() {
+		// Flush any pending write-behind save before the document goes away
+		DisableWriteBehind();
 		delete jsonDocument;
 	}
+	JsonFile(const JsonFile&) = delete;
+	JsonFile& operator=(const JsonFile&) = delete;
 
 
 	// Import and Export functions exposed by the API
 	bool Load(const std::string& fileName) {
-		this->fileName = fileName;
-		if (fileName != "NOT GIVEN") {
-			// Check if we've already loaded the file
-			if (jsonDocument != nullptr) {
-				delete jsonDocument;
-			}
-			std::ifstream fileStream(fileName);
-			rapidjson::IStreamWrapper inputStream(fileStream);
-			jsonDocument = new rapidjson::Document();
-			jsonDocument->ParseStream(inputStream);
-
-			if (jsonDocument->HasParseError()) {
-				std::cout << "JsonFile.hpp >>>> File: " << fileName << " was not loaded" << std::endl;
-				std::cout << "JsonFile.hpp >>>> Parser Errors: " << rapidjson::GetParseError_En(jsonDocument->GetParseError()) << std::endl;
-				isFileLoaded = false;
-				return false;
-			}
-			else {
-				std::cout << "JsonFile.hpp >>>> File: " << fileName << " was loaded successfully" << std::endl;
-				isFileLoaded = true;
-				return true;
-			}
+		return LoadFile(fileName, nullptr, nullptr, true);
+	}
+	// Loads the file and validates it against schema in the same pass, instead of walking the loaded document a second time.
+	// When stopOnFirstError is false a failed validation is reported but the document is still loaded
+	bool Load(const std::string& fileName, const JsonSchema& schema, std::vector<JsonSchemaViolation>* violations = nullptr, const bool& stopOnFirstError = true) {
+		if (!schema.IsLoaded()) {
+			std::cout << "JsonFile.hpp >>>> Schema: " << schema.GetSchemaFileName() << " is not loaded, cannot validate File: " << fileName << std::endl;
+			return false;
+		}
+		return LoadFile(fileName, &schema, violations, stopOnFirstError);
+	}
+	// Loads an entry out of a packed content archive, the archive is only read during the call so it doesn't need to outlive the JsonFile.
+	// Archive entries are read-only, changes can still be made in memory but Save() will refuse to write them
+	bool LoadFromArchive(const JsonArchive& archive, const std::string& entryName) {
+		JSON_TRACE_SCOPE("LoadFromArchive", entryName, archive.GetArchiveName());
+		Flush();
+		DocumentLock documentLock(*this);
+		ClearHistory();
+		this->fileName = entryName;
+		isArchiveEntry = true;
+		const char* entryData = nullptr;
+		size_t entrySize = 0;
+		if (!archive.Find(entryName, entryData, entrySize)) {
+			std::cout << "JsonFile.hpp >>>> Entry: " << entryName << " could not be found in archive: " << archive.GetArchiveName() << std::endl;
+			isFileLoaded = false;
+			return false;
+		}
+		// Check if we've already loaded the file
+		if (jsonDocument != nullptr) {
+			delete jsonDocument;
+		}
+		parallelChunks.clear();
+		jsonDocument = NewDocument();
+		JSON_TRACE_BYTES(entrySize);
+		rapidjson::ParseResult parseResult;
+		if (useParallelParse && !useInterning && !IsOutOfCoreDocument()) {
+			parseResult = ParseInParallel(entryData, entrySize);
 		}
 		else {
-			std::cout << "JsonFile.hpp >>>> File name was not supplied, no file was loaded" << std::endl;
+			rapidjson::MemoryStream inputStream(entryData, entrySize);
+			parseResult = ParseWithinBudget(inputStream);
+		}
+		StampChange(std::vector<std::string>());
+
+		if (parseResult.IsError()) {
+			std::cout << "JsonFile.hpp >>>> Entry: " << entryName << " was not loaded" << std::endl;
+			std::cout << "JsonFile.hpp >>>> Parser Errors: " << rapidjson::GetParseError_En(parseResult.Code()) << std::endl;
 			isFileLoaded = false;
 			return false;
 		}
+		else {
+			std::cout << "JsonFile.hpp >>>> Entry: " << entryName << " was loaded successfully" << std::endl;
+			isFileLoaded = true;
+			return true;
+		}
 	}
 	bool Save(void) {
+		JSON_TRACE_SCOPE("Save", fileName, "");
+		if (writeBehind != nullptr) {
+			// Route through the writer thread so saves stay ordered with the pending write-behind ones
+			return SaveAsync().get();
+		}
+		if (isArchiveEntry) {
+			std::cout << "JsonFile.hpp >>>> Entry: " << fileName << " was loaded from an archive, cannot call Save()" << std::endl;
+			return false;
+		}
 		if (isFileLoaded) {
+			std::lock_guard<std::mutex> fileLock(fileMutex);
 			std::ofstream outFileStream(fileName);
 			if (!outFileStream.is_open()) {
 				std::cout << "JsonFile.hpp >>>> File: " << fileName << " could not be opened for writing" << std::endl;
 				return false;
 			}
 			else {
-				rapidjson::OStreamWrapper outputStreamWrapper(outFileStream);
-				rapidjson::PrettyWriter<rapidjson::OStreamWrapper> fileWriter(outputStreamWrapper);
-				jsonDocument->Accept(fileWriter);
-				Load(fileName);	// Re-load the file now that we've changed it
+				// The document already matches what we're writing, so there is no need to re-load the file afterwards
+				WriteWithinBudget(outFileStream);
+				JSON_TRACE_BYTES(outFileStream.tellp());
 				return true;
 			}
 		}
@@ -74,11 +147,235 @@ public:
 		}
 	}
 
+	// Asynchronous import and export functions exposed by the API.
+	// The document must not be accessed until a LoadAsync() future is ready, SaveAsync() can be called at any time
+	std::future<bool> LoadAsync(const std::string& fileName) {
+		return std::async(std::launch::async, [this, fileName]() {
+			return Load(fileName);
+		});
+	}
+	std::future<bool> SaveAsync(void) {
+		std::promise<bool> savePromise;
+		std::future<bool> saveFuture = savePromise.get_future();
+		if (writeBehind == nullptr) {
+			// No writer thread to queue on, save on our own thread and hand back a ready future
+			savePromise.set_value(Save());
+			return saveFuture;
+		}
+		std::lock_guard<std::mutex> stateLock(writeBehind->stateMutex);
+		writeBehind->pendingSaves.push_back(std::move(savePromise));
+		writeBehind->wakeWriter.notify_one();
+		return saveFuture;
+	}
+
+	// Time-sliced loading, BeginLoad() starts a load which each Step() call advances for at most its budget, so a large file can be loaded across frames.
+	// The text is parsed a value at a time, containers bigger than sliceUnitBytes are opened up and parsed entry by entry instead of in one go.
+	// The current document stays queryable until the new one is complete and swapped in. Interning and parallel parsing aren't applied
+	enum class LoadState { Idle, Loading, NeedsData, Complete, Failed };
+	bool BeginLoad(const std::string& fileName, const size_t& sliceUnitBytes = 64 * 1024) {
+		CancelLoad();
+		Flush();
+		std::unique_ptr<TimeSlicedLoad> newLoad(new TimeSlicedLoad(fileName, sliceUnitBytes));
+		newLoad->fileStream.open(fileName, std::ios::binary);
+		if (!newLoad->fileStream.is_open()) {
+			std::cout << "JsonFile.hpp >>>> File: " << fileName << " could not be opened for loading" << std::endl;
+			return false;
+		}
+		newLoad->fileStream.seekg(0, std::ios::end);
+		newLoad->totalBytes = (size_t)newLoad->fileStream.tellg();
+		newLoad->fileStream.seekg(0, std::ios::beg);
+		newLoad->isReadingFile = true;
+		timeSlicedLoad = std::move(newLoad);
+		return true;
+	}
+	// Starts a load whose text is handed over in pieces with Feed(), fileName is only used as the file Save() writes to once the load completes
+	void BeginFeedLoad(const std::string& fileName, const size_t& sliceUnitBytes = 64 * 1024) {
+		CancelLoad();
+		timeSlicedLoad.reset(new TimeSlicedLoad(fileName, sliceUnitBytes));
+	}
+	void Feed(const char* data, const size_t& size) {
+		if (timeSlicedLoad == nullptr || timeSlicedLoad->isReadingFile || timeSlicedLoad->isInputFinished) {
+			std::cout << "JsonFile.hpp >>>> No load is waiting to be fed, call BeginFeedLoad() first" << std::endl;
+			return;
+		}
+		CompactLoadBuffer(*timeSlicedLoad);
+		timeSlicedLoad->buffer.append(data, size);
+		timeSlicedLoad->totalBytes += size;
+	}
+	// Tells the load there is no more text coming, the load can't complete until this has been called
+	void FinishFeeding(void) {
+		if (timeSlicedLoad != nullptr) {
+			timeSlicedLoad->isInputFinished = true;
+		}
+	}
+	// Parses for up to budget, a single value can overrun it by the time it takes to parse sliceUnitBytes of text.
+	// NeedsData means a fed load has parsed everything it has been given so far
+	LoadState Step(const std::chrono::microseconds& budget) {
+		if (timeSlicedLoad == nullptr) {
+			return LoadState::Idle;
+		}
+		const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + budget;
+		while (true) {
+			const SliceResult sliceResult = ParseNextSlice(*timeSlicedLoad);
+			if (sliceResult == SliceResult::Failed) {
+				timeSlicedLoad.reset();
+				return LoadState::Failed;
+			}
+			if (sliceResult == SliceResult::Finished) {
+				CompleteTimeSlicedLoad();
+				return LoadState::Complete;
+			}
+			if (sliceResult == SliceResult::NeedsData && !ReadNextBlock(*timeSlicedLoad)) {
+				return LoadState::NeedsData;
+			}
+			if (std::chrono::steady_clock::now() >= deadline) {
+				return LoadState::Loading;
+			}
+		}
+	}
+	void CancelLoad(void) {
+		timeSlicedLoad.reset();
+	}
+	const bool IsTimeSlicedLoading(void) const {
+		return timeSlicedLoad != nullptr;
+	}
+	// Fraction of the text parsed so far, a fed load measures against the text it has been given so far
+	const float LoadProgress(void) const {
+		if (timeSlicedLoad == nullptr || timeSlicedLoad->totalBytes == 0) {
+			return 0.0f;
+		}
+		return (float)((double)ParsedBytes(*timeSlicedLoad) / (double)timeSlicedLoad->totalBytes);
+	}
+	const size_t BytesRemaining(void) const {
+		if (timeSlicedLoad == nullptr) {
+			return 0;
+		}
+		return timeSlicedLoad->totalBytes - ParsedBytes(*timeSlicedLoad);
+	}
+
+	// Write-behind mode, changes mark the document dirty and a background thread saves a snapshot once no changes have been made for debounceTime.
+	// Bursts of Set<T>()/Insert<T>()/Remove() calls are coalesced into a single write, and pending changes are flushed on destruction
+	void EnableWriteBehind(const std::chrono::milliseconds& debounceTime) {
+		if (writeBehind != nullptr) {
+			std::lock_guard<std::mutex> stateLock(writeBehind->stateMutex);
+			writeBehind->debounceTime = debounceTime;
+			return;
+		}
+		writeBehind.reset(new WriteBehindState());
+		writeBehind->debounceTime = debounceTime;
+		writeBehind->writerThread = std::thread(&JsonFile::WriteBehindLoop, this);
+	}
+	void DisableWriteBehind(void) {
+		if (writeBehind == nullptr) {
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> stateLock(writeBehind->stateMutex);
+			writeBehind->isStopRequested = true;
+			writeBehind->wakeWriter.notify_one();
+		}
+		writeBehind->writerThread.join();
+		writeBehind.reset();
+	}
+	// Blocks until every change made so far has been written to the file
+	bool Flush(void) {
+		if (writeBehind == nullptr) {
+			return true;
+		}
+		{
+			std::unique_lock<std::mutex> stateLock(writeBehind->stateMutex);
+			if (!writeBehind->isDirty) {
+				// Nothing new to write, but a write already under way has to land before the file can be read or replaced
+				writeBehind->writeFinished.wait(stateLock, [this]() {
+					return !writeBehind->isWriting;
+				});
+				return writeBehind->wasLastWriteSuccessful;
+			}
+		}
+		return SaveAsync().get();
+	}
+	// True while there are changes which haven't reached the file yet, including ones being written right now
+	const bool IsDirty(void) {
+		if (writeBehind == nullptr) {
+			return false;
+		}
+		std::lock_guard<std::mutex> stateLock(writeBehind->stateMutex);
+		return writeBehind->isDirty || writeBehind->isWriting;
+	}
+
+	// Interning, deduplicates object keys, and string values up to maxInternedValueLength characters, into a pool shared by the whole document.
+	// Takes effect from the next Load(), keys added by Insert<T>() are pooled straight away
+	void EnableInterning(const size_t& maxInternedValueLength = 0) {
+		useInterning = true;
+		this->maxInternedValueLength = maxInternedValueLength;
+	}
+	void DisableInterning(void) {
+		useInterning = false;
+	}
+	const bool IsInterning(void) const {
+		return useInterning;
+	}
+	// Statistics for the pool backing the current document, BytesSaved() is the allocator memory saved against a non-interned load after the pool's own costs
+	const JsonStringPool& GetStringPool(void) const {
+		return stringPool;
+	}
+
+	// Parallel parsing, files whose largest array is at least minimumArrayBytes long have that array's elements split into contiguous ranges
+	// and parsed on numberOfThreads threads (0 uses every core), then moved into a single array in the document.
+	// Takes effect from the next Load(), files loaded with interning or a schema are parsed on one thread
+	void EnableParallelParse(const size_t& minimumArrayBytes = 1 << 20, const size_t& numberOfThreads = 0) {
+		useParallelParse = true;
+		parallelMinimumArrayBytes = minimumArrayBytes;
+		parallelThreadCount = numberOfThreads;
+	}
+	void DisableParallelParse(void) {
+		useParallelParse = false;
+	}
+
+	// Out-of-core mode, for files whose document won't fit in memory. The document is built in a memory mapped scratch file of arenaCapacity bytes
+	// instead of on the heap, and its pages are handed back to the OS whenever about residentBudgetBytes have been touched, being paged back in as they're read.
+	// Loads and saves stay within the budget on their own, call TrimResidentMemory() after a run of reads to release the pages they brought in.
+	// The parser's stack gets a second scratch file, scratchFileName + ".stack", and write-behind saves stream the document out rather than snapshotting it.
+	// Takes effect from the next Load(), parallel parsing is skipped and anything beyond arenaCapacity spills over onto the heap
+	void EnableOutOfCore(const std::string& scratchFileName, const size_t& residentBudgetBytes, const size_t& arenaCapacity) {
+		useOutOfCore = true;
+		outOfCoreFileName = scratchFileName;
+		outOfCoreBudget = residentBudgetBytes;
+		outOfCoreCapacity = arenaCapacity;
+	}
+	void DisableOutOfCore(void) {
+		useOutOfCore = false;
+	}
+	const bool IsOutOfCore(void) const {
+		return useOutOfCore;
+	}
+	void TrimResidentMemory(void) {
+		std::lock_guard<std::mutex> documentLock(documentMutex);
+		if (IsOutOfCoreDocument()) {
+			outOfCoreArena->Release(outOfCoreAllocator->Size());
+		}
+	}
+
 	// general functions exposed by the API
 	const bool IsLoaded(void) {
 		return isFileLoaded;
 	}
+	// Bytes reserved by the document's allocator, this is the bulk of the memory a loaded file holds on to
+	const size_t MemoryUsage(void) {
+		if (jsonDocument == nullptr) {
+			return 0;
+		}
+		// An out-of-core arena's capacity is only reserved address space, so count what the document actually uses of it
+		size_t memoryUsage = IsOutOfCoreDocument() ? jsonDocument->GetAllocator().Size() : jsonDocument->GetAllocator().Capacity();
+		for (const std::unique_ptr<rapidjson::Document>& parallelChunk : parallelChunks) {
+			memoryUsage += parallelChunk->GetAllocator().Capacity();
+		}
+		memoryUsage += stringPool.PoolBytes();	// Interned strings live in the pool rather than the document's allocator
+		memoryUsage += historyAllocator->Capacity();
+		return memoryUsage;
+	}
 	const size_t SizeOfObjectArray(const std::string& objectName) {
+		JSON_TRACE_SCOPE("SizeOfObjectArray", fileName, objectName);
 		// Check we've been given a key
 		if (objectName != "") {
 			// check the file is actually loaded
@@ -140,6 +437,11 @@ public:
 					return 0;
 				}
 
+				// Packed arrays know their size from the length of their payload, no need to decode them
+				if (IsPackedString(*jsonValue)) {
+					return PackedArraySize(*jsonValue);
+				}
+
 				// Check we haven't ended up with a key that isn't an array
 				if (!jsonValue->IsArray()) {
 					std::cout << "JsonFile.hpp >>>> " << objectName << " is not an array" << std::endl;
@@ -162,6 +464,7 @@ public:
 	
 	// Get Functions exposed by the API
 	template<typename T> inline T Get(const std::string& objectName) {
+		JSON_TRACE_SCOPE("Get", fileName, objectName);
 		// Check we've been given a key
 		if (objectName != "") {
 			// check the file is actually loaded
@@ -236,6 +539,7 @@ public:
 		}
 	}
 	template<typename T> inline std::vector<T> GetVector(const std::string& objectName) {
+		JSON_TRACE_SCOPE("GetVector", fileName, objectName);
 		// Check we've been given a key
 		if (objectName != "") {
 			std::vector<T> result;
@@ -298,6 +602,12 @@ public:
 					return std::vector<T>();
 				}
 
+				// Packed arrays are stored as a tagged base64 string
+				if (IsPackedString(*jsonValue)) {
+					DecodePackedArray<T>(*jsonValue, result);
+					return result;
+				}
+
 				// Check we haven't ended up with a key that isn't an array
 				if (!jsonValue->IsArray()) {
 					std::cout << "JsonFile.hpp >>>> " << objectName << " is not an array" << std::endl;
@@ -322,8 +632,351 @@ public:
 		}
 	}
 	
+	// Lazy typed view of a JSON array, elements are only converted to T when read and nothing is allocated until ToVector() is called.
+	// The view points into the document, so it is invalidated by any change to the file.
+	template<typename T> class ArrayView {
+	public:
+		// Iterator that converts each element on dereference. It hands back values rather than references, so it can only honestly claim to be an input iterator,
+		// the offset and comparison operators are still there for code that uses them directly
+		class Iterator {
+		public:
+			typedef std::input_iterator_tag iterator_category;
+			typedef T value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef void pointer;		// There is no element of type T to point at, std::iterator_traits still needs the member
+			typedef T reference;
+
+			Iterator(void) : owner(nullptr), element(nullptr) {}
+			Iterator(JsonFile* owner, const rapidjson::Value* element) : owner(owner), element(element) {}
+
+			T operator*(void) const {
+				return owner->GetValue<T>(*element);
+			}
+			T operator[](const difference_type& offset) const {
+				return owner->GetValue<T>(element[offset]);
+			}
+			Iterator& operator++(void) {
+				++element;
+				return *this;
+			}
+			Iterator operator++(int) {
+				Iterator previous = *this;
+				++element;
+				return previous;
+			}
+			Iterator& operator--(void) {
+				--element;
+				return *this;
+			}
+			Iterator operator--(int) {
+				Iterator previous = *this;
+				--element;
+				return previous;
+			}
+			Iterator& operator+=(const difference_type& offset) {
+				element += offset;
+				return *this;
+			}
+			Iterator& operator-=(const difference_type& offset) {
+				element -= offset;
+				return *this;
+			}
+			Iterator operator+(const difference_type& offset) const {
+				return Iterator(owner, element + offset);
+			}
+			Iterator operator-(const difference_type& offset) const {
+				return Iterator(owner, element - offset);
+			}
+			difference_type operator-(const Iterator& other) const {
+				return element - other.element;
+			}
+			bool operator==(const Iterator& other) const {
+				return element == other.element;
+			}
+			bool operator!=(const Iterator& other) const {
+				return element != other.element;
+			}
+			bool operator<(const Iterator& other) const {
+				return element < other.element;
+			}
+
+		private:
+			JsonFile* owner;
+			const rapidjson::Value* element;
+		};
+
+		// Constructors
+		ArrayView(void) : owner(nullptr), firstElement(nullptr), elementCount(0) {}
+		ArrayView(JsonFile* owner, const rapidjson::Value* firstElement, const size_t& elementCount) : owner(owner), firstElement(firstElement), elementCount(elementCount) {}
+
+		// The size is read straight from the array, there is no second traversal
+		size_t size(void) const {
+			return elementCount;
+		}
+		bool empty(void) const {
+			return elementCount == 0;
+		}
+
+		// Unchecked index access, the element's type is still checked during the conversion
+		T operator[](const size_t& index) const {
+			return owner->GetValue<T>(firstElement[index]);
+		}
+		// Bounds checked index access
+		T At(const size_t& index) const {
+			if (index < elementCount) {
+				return owner->GetValue<T>(firstElement[index]);
+			}
+			else {
+				std::cout << "JsonFile.hpp >>>> ArrayView index: " << index << " is out of bounds" << std::endl;
+				return owner->GetDefaultValue<T>();
+			}
+		}
+
+		Iterator begin(void) const {
+			return Iterator(owner, firstElement);
+		}
+		Iterator end(void) const {
+			return Iterator(owner, firstElement + elementCount);
+		}
+
+		// Returns a view of [offset, offset + length), clamped to the bounds of this view
+		ArrayView Slice(const size_t& offset, const size_t& length) const {
+			if (offset >= elementCount) {
+				return ArrayView(owner, firstElement + elementCount, 0);
+			}
+			const size_t remaining = elementCount - offset;
+			return ArrayView(owner, firstElement + offset, (length < remaining) ? length : remaining);
+		}
+
+		// Copies the viewed elements out, this is the only call on the view which allocates
+		std::vector<T> ToVector(void) const {
+			std::vector<T> result;
+			result.reserve(elementCount);
+			for (size_t i = 0; i < elementCount; i++) {
+				result.push_back(owner->GetValue<T>(firstElement[i]));
+			}
+			return result;
+		}
+
+	private:
+		JsonFile* owner;
+		const rapidjson::Value* firstElement;
+		size_t elementCount;
+	};
+
+	// Array view getter, returns an empty view if the key could not be found or isn't an array
+	template<typename T> inline ArrayView<T> GetArrayView(const std::string& objectName) {
+		// Check we've been given a key
+		if (objectName != "") {
+			if (isFileLoaded) {
+				const rapidjson::Value* jsonValue = TraverseToValue(objectName);
+				if (jsonValue == nullptr) {
+					return ArrayView<T>();
+				}
+				// Check we haven't ended up with a JSON object instead of a value
+				if (jsonValue->IsObject()) {
+					std::cout << "JsonFile.hpp >>>> " << objectName << " is an object" << std::endl;
+					return ArrayView<T>();
+				}
+				// Packed elements aren't rapidjson values, so there is nothing to view
+				if (IsPackedString(*jsonValue)) {
+					std::cout << "JsonFile.hpp >>>> " << objectName << " is a packed array, read it with GetVector<T>()" << std::endl;
+					return ArrayView<T>();
+				}
+				// Check we haven't ended up with a key that isn't an array
+				if (!jsonValue->IsArray()) {
+					std::cout << "JsonFile.hpp >>>> " << objectName << " is not an array" << std::endl;
+					return ArrayView<T>();
+				}
+				return ArrayView<T>(this, jsonValue->Begin(), jsonValue->Size());
+			}
+			else {
+				std::cout << "JsonFile.hpp >>>> File is not loaded, cannot call GetArrayView<T>()" << std::endl;
+				return ArrayView<T>();
+			}
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> No key was defined for GetArrayView<T>() to use for traversal" << std::endl;
+			return ArrayView<T>();
+		}
+	}
+
+	// Types which can be read through the type-erased batch APIs
+	enum class ValueKind { Int, Float, Double, String, StringView, Bool };
+	// Per-entry result of a GetMany() call
+	enum class BatchStatus { Pending, Found, NotFound, IsObject, TypeMismatch };
+	// A (path, type, output slot) entry for GetMany(), create these with MakeBatchEntry<T>() so the kind always matches the output
+	struct BatchEntry {
+		std::string path = "";
+		ValueKind kind = ValueKind::Int;
+		void* output = nullptr;
+		BatchStatus status = BatchStatus::Pending;
+	};
+	template<typename T> static inline BatchEntry MakeBatchEntry(const std::string& path, T* output) {
+		BatchEntry entry;
+		entry.path = path;
+		entry.kind = KindOf(output);
+		entry.output = output;
+		return entry;
+	}
+
+	// Batched get exposed by the API, the entries' paths are merged into a prefix trie so each shared prefix is only walked once.
+	// Outputs are only written for entries that end up Found, returns the number of entries that were found
+	inline size_t GetMany(std::vector<BatchEntry>& entries) {
+		if (!isFileLoaded) {
+			std::cout << "JsonFile.hpp >>>> File is not loaded, cannot call GetMany()" << std::endl;
+			for (BatchEntry& entry : entries) {
+				entry.status = BatchStatus::NotFound;
+			}
+			return 0;
+		}
+
+		// Build the trie, node 0 is the document root
+		std::vector<BatchTrieNode> trie(1);
+		const size_t numberOfEntries = entries.size();
+		for (size_t i = 0; i < numberOfEntries; i++) {
+			entries[i].status = BatchStatus::Pending;
+			if (entries[i].path == "") {
+				entries[i].status = BatchStatus::NotFound;
+				continue;
+			}
+			size_t currentNode = 0;
+			for (const std::string& key : SplitString(entries[i].path, '.')) {
+				std::map<std::string, size_t>::const_iterator child = trie[currentNode].children.find(key);
+				if (child != trie[currentNode].children.end()) {
+					currentNode = child->second;
+				}
+				else {
+					trie.push_back(BatchTrieNode());
+					trie[currentNode].children[key] = trie.size() - 1;
+					currentNode = trie.size() - 1;
+				}
+			}
+			trie[currentNode].entries.push_back(i);
+		}
+
+		// Walk the trie against the DOM, each distinct node is resolved once
+		size_t foundCount = 0;
+		ResolveBatchNode(trie, 0, jsonDocument, entries, foundCount);
+		return foundCount;
+	}
+
+	// A (relative path, type, output column) field for ExtractColumns(), create these with MakeColumn<T>() so the kind always matches the column.
+	// presence is optional, when given it gets a bit per row saying whether the field was found with the right type
+	struct ColumnSpec {
+		std::string path = "";
+		ValueKind kind = ValueKind::Int;
+		void* column = nullptr;
+		std::vector<bool>* presence = nullptr;
+	};
+	template<typename T> static inline ColumnSpec MakeColumn(const std::string& path, std::vector<T>* column, std::vector<bool>* presence = nullptr) {
+		ColumnSpec columnSpec;
+		columnSpec.path = path;
+		columnSpec.kind = KindOf(static_cast<T*>(nullptr));
+		columnSpec.column = column;
+		columnSpec.presence = presence;
+		return columnSpec;
+	}
+
+	// Columnar extraction exposed by the API, reads every column's field out of each element of the array at arrayPath in a single pass.
+	// E.g. ExtractColumns("engine.key bindings", { MakeColumn("binding.id", &ids), MakeColumn("binding.key value", &keyValues, &hasKeyValue) }).
+	// Each column is resized to one row per element, rows missing the field are left as T(). Returns the number of rows
+	inline size_t ExtractColumns(const std::string& arrayPath, const std::vector<ColumnSpec>& columns) {
+		// Check we've been given a key
+		if (arrayPath != "") {
+			if (isFileLoaded) {
+				const rapidjson::Value* jsonValue = TraverseToValue(arrayPath);
+				if (jsonValue == nullptr) {
+					return 0;
+				}
+				if (IsPackedString(*jsonValue)) {
+					std::cout << "JsonFile.hpp >>>> " << arrayPath << " is a packed array, its elements have no fields to extract" << std::endl;
+					return 0;
+				}
+				if (!jsonValue->IsArray()) {
+					std::cout << "JsonFile.hpp >>>> " << arrayPath << " is not an array" << std::endl;
+					return 0;
+				}
+
+				// Size every column up front and split the field paths once, rather than per row
+				const size_t numberOfRows = jsonValue->Size();
+				const size_t numberOfColumns = columns.size();
+				std::vector<std::vector<std::string>> fieldPaths(numberOfColumns);
+				for (size_t i = 0; i < numberOfColumns; i++) {
+					fieldPaths[i] = SplitString(columns[i].path, '.');
+					ResizeColumn(columns[i].kind, columns[i].column, numberOfRows);
+					if (columns[i].presence != nullptr) {
+						columns[i].presence->assign(numberOfRows, false);
+					}
+				}
+				for (size_t row = 0; row < numberOfRows; row++) {
+					const rapidjson::Value& element = (*jsonValue)[(rapidjson::SizeType)row];
+					for (size_t i = 0; i < numberOfColumns; i++) {
+						const rapidjson::Value* fieldValue = FindRelativeValue(element, fieldPaths[i]);
+						const bool isPresent = (fieldValue != nullptr) && WriteColumnCell(*fieldValue, columns[i].kind, columns[i].column, row);
+						if (columns[i].presence != nullptr) {
+							(*columns[i].presence)[row] = isPresent;
+						}
+					}
+				}
+				return numberOfRows;
+			}
+			else {
+				std::cout << "JsonFile.hpp >>>> File is not loaded, cannot call ExtractColumns()" << std::endl;
+				return 0;
+			}
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> No key was defined for ExtractColumns() to use for traversal" << std::endl;
+			return 0;
+		}
+	}
+
+	// Query function exposed by the API, evaluates a path containing wildcards, ranges and filters in a single traversal of the DOM.
+	// Segments can be a key/index, "*" for every element or member, "start:end" for a half-open range of array elements (either side optional)
+	// or "[relative.path op literal]" to keep the elements whose relative value compares true, where op is one of = != < <= > >=.
+	// E.g. "engine.key bindings.*.binding.id" or "engine.key bindings.[binding.key value>=10].binding.id"
+	template<typename T> inline std::vector<T> Query(const std::string& queryPath) {
+		std::vector<T> result;
+		// Check we've been given a query
+		if (queryPath != "") {
+			if (isFileLoaded) {
+				std::vector<QuerySegment> querySegments;
+				if (!ParseQuery(queryPath, querySegments)) {
+					return result;
+				}
+				// Collect every matching node first, then convert them in one go
+				std::vector<const rapidjson::Value*> matches;
+				CollectQueryMatches(*jsonDocument, querySegments, 0, matches);
+				result.reserve(matches.size());
+				for (const rapidjson::Value* match : matches) {
+					result.push_back(GetValue<T>(*match));
+				}
+				return result;
+			}
+			else {
+				std::cout << "JsonFile.hpp >>>> File is not loaded, cannot call Query<T>()" << std::endl;
+				return result;
+			}
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> No query was defined for Query<T>() to evaluate" << std::endl;
+			return result;
+		}
+	}
+
+	// Zero-copy string getters, the returned views point into the document and are invalidated by any change to the file
+	inline JsonStringView GetView(const std::string& objectName) {
+		return Get<JsonStringView>(objectName);
+	}
+	inline std::vector<JsonStringView> GetViewVector(const std::string& objectName) {
+		return GetVector<JsonStringView>(objectName);
+	}
+	
 	// Set Functions exposed by the API
 	template<typename T> inline void Set(const std::string& objectName, const T& inputValue) {
+		JSON_TRACE_SCOPE("Set", fileName, objectName);
+		DocumentLock documentLock(*this);
 		// Check we've been given a key
 		if (objectName != "") {
 			// check the file is actually loaded
@@ -386,9 +1039,11 @@ public:
 				}
 
 				// We've reached our depth in the DOM, amend the value
+				rapidjson::Value* historyBefore = CopyForHistory(*jsonValue);
 				if (SetValue<T>(*jsonValue, inputValue)) {
+					RecordHistory(objectName, historyBefore, jsonValue);
 					// If we've successfully set the value, save the doc
-					if (!Save()) {
+					if (!CommitChanges()) {
 						std::cout << "JsonFile.hpp >>>> Failed to save file" << std::endl;
 					}
 				}
@@ -407,6 +1062,8 @@ public:
 		}
 	}
 	template<typename T> inline void Set(const std::string& objectName, const std::vector<T>& inputValueVector) {
+		JSON_TRACE_SCOPE("Set", fileName, objectName);
+		DocumentLock documentLock(*this);
 		// Check we've been given a key
 		if (objectName != "") {
 			// check the file is actually loaded
@@ -467,16 +1124,29 @@ public:
 					std::cout << "JsonFile.hpp >>>> " << objectName << " is an object" << std::endl;
 					return;
 				}
+				// Packed arrays keep their element type when they are overwritten
+				if (IsPackedString(*jsonValue)) {
+					rapidjson::Value* historyBefore = CopyForHistory(*jsonValue);
+					if (SetPackedValue<T>(*jsonValue, inputValueVector, GetPackedType(*jsonValue))) {
+						RecordHistory(objectName, historyBefore, jsonValue);
+						if (!CommitChanges()) {
+							std::cout << "JsonFile.hpp >>>> Failed to save file" << std::endl;
+						}
+					}
+					return;
+				}
 				// Check we haven't ended up with a key that isn't an array
 				if (!jsonValue->IsArray()) {
 					std::cout << "JsonFile.hpp >>>> " << objectName << " is not an array" << std::endl;
 					return;
 				}
 
+				rapidjson::Value* historyBefore = CopyForHistory(*jsonValue);
 				SetVectorOfValues<T>(*jsonValue, inputValueVector);
+				RecordHistory(objectName, historyBefore, jsonValue);
 
 				// If we've successfully set the value, save the doc
-				if (!Save()) {
+				if (!CommitChanges()) {
 					std::cout << "JsonFile.hpp >>>> Failed to save file" << std::endl;
 				}
 			}
@@ -491,25 +1161,120 @@ public:
 		}
 	}
 	
-	// Inserts Functions exposed by the API
-	template<typename T> inline void Insert(const std::string& positionToInsert, const std::string& keyName, const T& inputValue) {
-		// Check the file is loaded
-		if (isFileLoaded) {
-			std::vector<std::string> splitString = SplitString(positionToInsert, '.');	// this gives us the stack of node names to use to traverse the json file's structure, e.g. root.head.value
-			rapidjson::Value* jsonValue = nullptr;
-
-			// Iterate through our substrings to traverse the JSON DOM
-			const size_t sizeOfSplitString = splitString.size();
-			if (sizeOfSplitString == 0) {
-				// If the position to insert is the root
-				jsonValue = &(*jsonDocument);
-				InsertValue<T>(*jsonValue, keyName, inputValue);
+	// Packed array Functions exposed by the API. A packed array is a string holding "@packed:<type>:" followed by the base64 of its little-endian elements,
+	// GetVector<T>(), Set<T>(vector) and SizeOfObjectArray() read and write them just like normal arrays.
+	// Element paths such as "array.0", GetArrayView<T>(), Query<T>() and ExtractColumns() don't decode them, read their elements with GetVector<T>() instead
+	enum class PackedType { Int8, Int16, Int32, Float32, Float64 };
+	// Off by default, so strings which happen to start with "@packed:" are only treated as packed arrays once a file is known to use them
+	void EnablePackedArrays(void) {
+		usePackedArrays = true;
+	}
+	void DisablePackedArrays(void) {
+		usePackedArrays = false;
+	}
+	const bool IsUsingPackedArrays(void) const {
+		return usePackedArrays;
+	}
+	// Replaces the array, or packed array, at objectName with a packed array of packedType elements
+	template<typename T> inline void SetPacked(const std::string& objectName, const std::vector<T>& inputValueVector, const PackedType& packedType) {
+		JSON_TRACE_SCOPE("SetPacked", fileName, objectName);
+		DocumentLock documentLock(*this);
+		if (!usePackedArrays) {
+			std::cout << "JsonFile.hpp >>>> Packed arrays are disabled, call EnablePackedArrays() before SetPacked<T>()" << std::endl;
+			return;
+		}
+		// Check we've been given a key
+		if (objectName != "") {
+			if (isFileLoaded) {
+				rapidjson::Value* jsonValue = TraverseToValue(objectName);
+				if (jsonValue == nullptr) {
+					return;
+				}
+				if (!jsonValue->IsArray() && !IsPackedString(*jsonValue)) {
+					std::cout << "JsonFile.hpp >>>> " << objectName << " is not an array" << std::endl;
+					return;
+				}
+				rapidjson::Value* historyBefore = CopyForHistory(*jsonValue);
+				if (SetPackedValue<T>(*jsonValue, inputValueVector, packedType)) {
+					RecordHistory(objectName, historyBefore, jsonValue);
+					if (!CommitChanges()) {
+						std::cout << "JsonFile.hpp >>>> Failed to save file" << std::endl;
+					}
+				}
 			}
 			else {
-				for (size_t i = 0; i < sizeOfSplitString; i++) {
-					if (i == 0) {
-						if (!jsonDocument->HasMember(splitString.front().c_str())) {
-							std::cout << "JsonFile.hpp >>>> Could not find key: " << splitString.front() << std::endl;
+				std::cout << "JsonFile.hpp >>>> File is not loaded, cannot call SetPacked<T>()" << std::endl;
+			}
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> No key was defined for SetPacked<T>() to use for traversal" << std::endl;
+		}
+	}
+	template<typename T> inline void InsertPacked(const std::string& positionToInsert, const std::string& keyName, const std::vector<T>& inputValueVector, const PackedType& packedType) {
+		JSON_TRACE_SCOPE("InsertPacked", fileName, positionToInsert);
+		DocumentLock documentLock(*this);
+		if (!usePackedArrays) {
+			std::cout << "JsonFile.hpp >>>> Packed arrays are disabled, call EnablePackedArrays() before InsertPacked<T>()" << std::endl;
+			return;
+		}
+		// Check the file is loaded
+		if (isFileLoaded) {
+			rapidjson::Value* jsonValue = (positionToInsert != "") ? TraverseToValue(positionToInsert) : jsonDocument;
+			if (jsonValue == nullptr) {
+				return;
+			}
+			if (!jsonValue->IsObject()) {
+				std::cout << "JsonFile.hpp >>>> Values can only be inserted into objects, not values" << std::endl;
+				return;
+			}
+			if (jsonValue->HasMember(keyName.c_str())) {
+				std::cout << "JsonFile.hpp >>>> Key: " << keyName << " Already exists in the document" << std::endl;
+				return;
+			}
+			rapidjson::Value newPackedArray;
+			if (!SetPackedValue<T>(newPackedArray, inputValueVector, packedType)) {
+				return;
+			}
+			rapidjson::Value newKey;
+			SetKeyValue(newKey, keyName);
+			jsonValue->AddMember(newKey, newPackedArray, jsonDocument->GetAllocator());
+			RecordInsertHistory(positionToInsert, keyName, *jsonValue);
+			// Save the changes to the JSON file we have made
+			if (!CommitChanges()) {
+				std::cout << "JsonFile.hpp >>>> Failed to save file" << std::endl;
+			}
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> File is not loaded, cannot call InsertPacked<T>()" << std::endl;
+		}
+	}
+
+	// Inserts Functions exposed by the API
+	template<typename T> inline void Insert(const std::string& positionToInsert, const std::string& keyName, const T& inputValue) {
+		JSON_TRACE_SCOPE("Insert", fileName, positionToInsert);
+		DocumentLock documentLock(*this);
+		// Check the file is loaded
+		if (isFileLoaded) {
+			std::vector<std::string> splitString = SplitString(positionToInsert, '.');	// this gives us the stack of node names to use to traverse the json file's structure, e.g. root.head.value
+			rapidjson::Value* jsonValue = nullptr;
+
+			// Iterate through our substrings to traverse the JSON DOM
+			const size_t sizeOfSplitString = splitString.size();
+			if (sizeOfSplitString == 0) {
+				// If the position to insert is the root
+				jsonValue = &(*jsonDocument);
+				if (InsertValue<T>(*jsonValue, keyName, inputValue)) {
+					RecordInsertHistory(positionToInsert, keyName, *jsonValue);
+					if (!CommitChanges()) {
+						std::cout << "JsonFile.hpp >>>> Failed to save file" << std::endl;
+					}
+				}
+			}
+			else {
+				for (size_t i = 0; i < sizeOfSplitString; i++) {
+					if (i == 0) {
+						if (!jsonDocument->HasMember(splitString.front().c_str())) {
+							std::cout << "JsonFile.hpp >>>> Could not find key: " << splitString.front() << std::endl;
 							return;
 						}
 						jsonValue = &(*jsonDocument)[splitString.front().c_str()];	// Get our root key
@@ -553,7 +1318,12 @@ public:
 						}
 					}
 				}
-				InsertValue<T>(*jsonValue, keyName, inputValue);
+				if (InsertValue<T>(*jsonValue, keyName, inputValue)) {
+					RecordInsertHistory(positionToInsert, keyName, *jsonValue);
+					if (!CommitChanges()) {
+						std::cout << "JsonFile.hpp >>>> Failed to save file" << std::endl;
+					}
+				}
 			}
 		}
 		else {
@@ -562,6 +1332,8 @@ public:
 		}
 	}
 	template<typename T> inline void Insert(const std::string& positionToInsert, const std::string& keyName, const std::vector<T>& inputValueVector) {
+		JSON_TRACE_SCOPE("Insert", fileName, positionToInsert);
+		DocumentLock documentLock(*this);
 		// Check the file is loaded
 		if (isFileLoaded) {
 			std::vector<std::string> splitString = SplitString(positionToInsert, '.');	// this gives us the stack of node names to use to traverse the json file's structure, e.g. root.head.value
@@ -572,7 +1344,12 @@ public:
 			if (sizeOfSplitString == 0) {
 				// If the position to insert is the root
 				jsonValue = &(*jsonDocument);
-				InsertVectorOfValues<T>(*jsonValue, keyName, inputValueVector);
+				if (InsertVectorOfValues<T>(*jsonValue, keyName, inputValueVector)) {
+					RecordInsertHistory(positionToInsert, keyName, *jsonValue);
+					if (!CommitChanges()) {
+						std::cout << "JsonFile.hpp >>>> Failed to save file" << std::endl;
+					}
+				}
 			}
 			else {
 				for (size_t i = 0; i < sizeOfSplitString; i++) {
@@ -622,7 +1399,12 @@ public:
 						}
 					}
 				}
-				InsertVectorOfValues<T>(*jsonValue, keyName, inputValueVector);
+				if (InsertVectorOfValues<T>(*jsonValue, keyName, inputValueVector)) {
+					RecordInsertHistory(positionToInsert, keyName, *jsonValue);
+					if (!CommitChanges()) {
+						std::cout << "JsonFile.hpp >>>> Failed to save file" << std::endl;
+					}
+				}
 			}
 		}
 		else {
@@ -631,8 +1413,157 @@ public:
 		}
 	}
 	
+	// Snapshot Functions exposed by the API, every Set<T>()/Insert<T>()/Remove() is journalled as the before and after copies of the node it changed.
+	// Taking a snapshot is O(1) and restoring one replays the journal, so an edit only costs a copy of the changed node rather than the document
+	void EnableHistory(const size_t& historyLimit) {
+		std::lock_guard<std::mutex> documentLock(documentMutex);
+		this->historyLimit = historyLimit;
+		TrimHistory();
+	}
+	void DisableHistory(void) {
+		std::lock_guard<std::mutex> documentLock(documentMutex);
+		ClearHistory();
+		historyLimit = 0;
+	}
+	// Returns an id for the document's current state which Restore() can return to while it is still within the history limit
+	const size_t Snapshot(void) {
+		return historyBaseVersion + historyPosition;
+	}
+	bool Restore(const size_t& snapshot) {
+		DocumentLock documentLock(*this);
+		if (!isFileLoaded) {
+			std::cout << "JsonFile.hpp >>>> File is not loaded, cannot call Restore()" << std::endl;
+			return false;
+		}
+		if (snapshot < historyBaseVersion || snapshot > historyBaseVersion + history.size()) {
+			std::cout << "JsonFile.hpp >>>> Snapshot: " << snapshot << " is no longer in the history" << std::endl;
+			return false;
+		}
+		const size_t targetPosition = snapshot - historyBaseVersion;
+		if (targetPosition == historyPosition) {
+			return true;
+		}
+		// Undo back, or redo forward, one edit at a time
+		while (historyPosition > targetPosition) {
+			historyPosition--;
+			ApplyHistoryEntry(history[historyPosition], true);
+		}
+		while (historyPosition < targetPosition) {
+			ApplyHistoryEntry(history[historyPosition], false);
+			historyPosition++;
+		}
+		if (!CommitChanges()) {
+			std::cout << "JsonFile.hpp >>>> Failed to save file" << std::endl;
+		}
+		return true;
+	}
+	bool Undo(void) {
+		if (historyPosition == 0) {
+			std::cout << "JsonFile.hpp >>>> Nothing to undo" << std::endl;
+			return false;
+		}
+		return Restore(Snapshot() - 1);
+	}
+	bool Redo(void) {
+		if (historyPosition == history.size()) {
+			std::cout << "JsonFile.hpp >>>> Nothing to redo" << std::endl;
+			return false;
+		}
+		return Restore(Snapshot() + 1);
+	}
+
+	// Change tracking Functions exposed by the API, every change bumps the document's version and stamps it on the path that changed and its parents.
+	// Consumers can ask whether anything under a prefix has changed since the version they last read at, instead of re-reading every value
+	typedef std::function<void(const std::string& changedPath, const size_t& version)> ChangeCallback;
+	const size_t GetVersion(void) {
+		std::lock_guard<std::mutex> documentLock(documentMutex);
+		return documentVersion;
+	}
+	// O(depth of prefix), an empty prefix asks about the whole document
+	const bool HasChangedSince(const std::string& prefix, const size_t& version) {
+		std::lock_guard<std::mutex> documentLock(documentMutex);
+		const std::vector<std::string> prefixPath = CanonicalPath(SplitString(prefix, '.'));
+		const VersionNode* versionNode = &versionRoot;
+		for (const std::string& key : prefixPath) {
+			// A replaced subtree has dropped its children's stamps, the replacement covers everything below it
+			if (versionNode->replacedVersion > version) {
+				return true;
+			}
+			std::map<std::string, std::unique_ptr<VersionNode>>::const_iterator child = versionNode->children.find(key);
+			if (child == versionNode->children.end()) {
+				return false;
+			}
+			versionNode = child->second.get();
+		}
+		return versionNode->version > version;
+	}
+	// Calls callback whenever something at, above or below prefix changes, returns an id for Unsubscribe().
+	// Callbacks run on the thread that made the change once the document has been unlocked, changedPath is "" when the whole document was re-loaded
+	const size_t Subscribe(const std::string& prefix, const ChangeCallback& callback) {
+		std::lock_guard<std::mutex> documentLock(documentMutex);
+		Subscription subscription;
+		subscription.id = nextSubscriptionId++;
+		subscription.prefix = CanonicalPath(SplitString(prefix, '.'));
+		subscription.callback = callback;
+		subscriptions.push_back(subscription);
+		return subscription.id;
+	}
+	bool Unsubscribe(const size_t& subscriptionId) {
+		std::lock_guard<std::mutex> documentLock(documentMutex);
+		for (std::vector<Subscription>::iterator subscription = subscriptions.begin(); subscription != subscriptions.end(); ++subscription) {
+			if (subscription->id == subscriptionId) {
+				subscriptions.erase(subscription);
+				return true;
+			}
+		}
+		std::cout << "JsonFile.hpp >>>> Subscription: " << subscriptionId << " does not exist" << std::endl;
+		return false;
+	}
+
+	// Hashing Functions exposed by the API, every object and array hashed is cached in a trie of subtree hashes which edits invalidate along their path.
+	// Object hashes don't depend on member order. Without EnableHashing() each call hashes the subtree from scratch
+	void EnableHashing(void) {
+		std::lock_guard<std::mutex> documentLock(documentMutex);
+		useHashing = true;
+	}
+	void DisableHashing(void) {
+		std::lock_guard<std::mutex> documentLock(documentMutex);
+		useHashing = false;
+		ClearHashes();
+	}
+	// 64 bit content hash of the value at path, an empty path hashes the whole document. Returns 0 if the value doesn't exist
+	const uint64_t HashOf(const std::string& path) {
+		uint64_t hash = 0;
+		if (!TryHashOf(path, hash)) {
+			return 0;
+		}
+		return hash;
+	}
+	// Compares the value at path in both files by hash, equal content always compares equal and a false match needs a 64 bit collision
+	const bool Equals(JsonFile& otherFile, const std::string& path) {
+		uint64_t hash = 0;
+		uint64_t otherHash = 0;
+		if (!TryHashOf(path, hash) || !otherFile.TryHashOf(path, otherHash)) {
+			return false;
+		}
+		return hash == otherHash;
+	}
+
+	// Publishes the whole document as the publisher's next version, so other processes can read it through a JsonSharedDocument.
+	// The document is flattened while locked, later changes need publishing again before readers can see them
+	bool PublishToSharedMemory(JsonSharedPublisher& publisher) {
+		std::lock_guard<std::mutex> documentLock(documentMutex);
+		if (!isFileLoaded) {
+			std::cout << "JsonFile.hpp >>>> File is not loaded, cannot call PublishToSharedMemory()" << std::endl;
+			return false;
+		}
+		return publisher.Publish(*jsonDocument);
+	}
+
 	// Remove Functions exposed by the API
 	inline void Remove(const std::string& objectName) {
+		JSON_TRACE_SCOPE("Remove", fileName, objectName);
+		DocumentLock documentLock(*this);
 		// Check we've been given a key
 		if (objectName != "") {
 			// check the file is actually loaded
@@ -649,7 +1580,7 @@ public:
 							return;
 						}
 						jsonValue = &(*jsonDocument)[splitString.front().c_str()];	// Get our root key
-						jsonValueParent = &(*jsonDocument)[splitString.front().c_str()];
+						jsonValueParent = jsonDocument;
 					}
 					else {
 						if (!jsonValue->IsArray()) {
@@ -693,9 +1624,11 @@ public:
 					}
 				}
 
+				rapidjson::Value* historyBefore = CopyForHistory(*jsonValue);
 				if (!jsonValueParent->IsArray()) {
 					if (jsonValueParent->EraseMember(rapidjson::StringRef(splitString.back().c_str()))) {
-						Save();
+						RecordHistory(objectName, historyBefore, nullptr);
+						CommitChanges();
 					}
 					else {
 						std::cout << "JsonFile.hpp >>>> Couldn't find key to remove" << std::endl;
@@ -716,7 +1649,8 @@ public:
 					if (arraySize > 0) {
 						if (arraySize > indexOfValue) {
 							jsonValueParent->Erase(jsonValue);
-							Save();
+							RecordHistory(objectName, historyBefore, nullptr);
+							CommitChanges();
 						}
 						else {
 							std::cout << "JsonFile.hpp >>>> " << objectName << " index: " << indexOfValue << " is out of bounds" << std::endl;
@@ -744,148 +1678,1996 @@ private:
 	// Private Variables
 	std::string fileName = "";
 	bool isFileLoaded = false;
+	bool isArchiveEntry = false;
+	bool useInterning = false;
+	bool usePackedArrays = false;
+	size_t maxInternedValueLength = 0;
+	JsonStringPool stringPool;	// Pooled strings are referenced by jsonDocument, so the pool is only cleared once the document is deleted
 	rapidjson::Document* jsonDocument = nullptr;
+	bool useOutOfCore = false;
+	std::string outOfCoreFileName = "";
+	size_t outOfCoreBudget = 0;
+	size_t outOfCoreCapacity = 0;
+	std::unique_ptr<JsonFileArena> outOfCoreArena;
+	std::unique_ptr<JsonFileArena> outOfCoreStackArena;	// Holds the parser's stack, which for a large array is every element parsed so far
+	std::unique_ptr<rapidjson::MemoryPoolAllocator<>> outOfCoreAllocator;	// Declared after the arena as clearing it writes to the arena's first page
+	bool useParallelParse = false;
+	size_t parallelMinimumArrayBytes = 0;
+	size_t parallelThreadCount = 0;
+	std::vector<std::unique_ptr<rapidjson::Document>> parallelChunks;	// Own the memory of the elements moved out of them into jsonDocument
 
-	// Splits a string using the given splitToken, E.g. ""The.Cat.Sat.On.The.Mat" splits with token '.' into Vector[6] = {The, Cat, Sat, On, The, Mat};
-	std::vector<std::string> JsonFile::SplitString(const std::string& stringToSplit, const char& splitToken) {
-
-		std::vector<std::string> splitString;	// Stores the split sections of string for the return.
-		std::string currentSplit = "";			// Stores the current section being split off.
-
-		size_t sizeOfStringArray = stringToSplit.size();			// .Size() of a const so it never changes and we store it once.
-		for (size_t i = 0; i < sizeOfStringArray; i++) {
-			char currentChar = stringToSplit.at(i);
-			if (currentChar == splitToken) {
-				splitString.push_back(currentSplit);
-				currentSplit = "";
+	// Body of both Load() functions, schema is nullptr when the file isn't being validated
+	bool LoadFile(const std::string& fileName, const JsonSchema* schema, std::vector<JsonSchemaViolation>* violations, const bool& stopOnFirstError) {
+		JSON_TRACE_SCOPE("Load", fileName, "");
+		// Make sure pending changes land in the file they were made to before we replace the document
+		Flush();
+		DocumentLock documentLock(*this);
+		ClearHistory();
+		this->fileName = fileName;
+		isArchiveEntry = false;
+		if (fileName != "NOT GIVEN") {
+			// Check if we've already loaded the file
+			if (jsonDocument != nullptr) {
+				delete jsonDocument;
+			}
+			parallelChunks.clear();
+			std::lock_guard<std::mutex> fileLock(fileMutex);	// Never read the file while Save() or the writer thread is part way through it
+			std::ifstream fileStream(fileName);
+			jsonDocument = NewDocument();
+			std::vector<JsonSchemaViolation> schemaViolations;
+			rapidjson::ParseResult parseResult;
+			if (schema != nullptr) {
+				rapidjson::IStreamWrapper inputStream(fileStream);
+				parseResult = ParseWithinBudget(inputStream, *schema, schemaViolations, stopOnFirstError);
+				JSON_TRACE_BYTES(inputStream.Tell());
+			}
+			else if (useParallelParse && !useInterning && !IsOutOfCoreDocument()) {
+				// The scan for the array needs the whole file in memory
+				const std::string fileText((std::istreambuf_iterator<char>(fileStream)), std::istreambuf_iterator<char>());
+				parseResult = ParseInParallel(fileText.data(), fileText.size());
+				JSON_TRACE_BYTES(fileText.size());
 			}
 			else {
-				currentSplit += currentChar;
+				rapidjson::IStreamWrapper inputStream(fileStream);
+				parseResult = ParseWithinBudget(inputStream);
+				JSON_TRACE_BYTES(inputStream.Tell());
 			}
-
-			if (i == sizeOfStringArray - 1 && currentChar != splitToken) {
-				// Catches the final section of string as there might not be a follow up split token.
-				splitString.push_back(currentSplit);
+			StampChange(std::vector<std::string>());	// The whole document has been replaced
+			for (const JsonSchemaViolation& schemaViolation : schemaViolations) {
+				std::cout << "JsonFile.hpp >>>> File: " << fileName << " failed schema validation, " << schemaViolation.documentPath << " breaks " << schemaViolation.keyword << " at " << schemaViolation.schemaPath << std::endl;
+			}
+			if (violations != nullptr) {
+				*violations = schemaViolations;
 			}
-		}
 
-		return splitString;
-	}
-	
-	// Get Default value Functions, uses Templating
-	template<typename T> inline T GetDefaultValue() {
-		return 0;
-	}
-	template<> inline std::string GetDefaultValue() {
-		return "";
-	}
-	
-	// Get value functions, uses Templating overrides
-	template<typename T> inline T GetValue(const rapidjson::Value& jsonValue) {
-		return GetDefaultValue<T>();
-	}
-	template<> inline int GetValue(const rapidjson::Value& jsonValue) {
-		if (jsonValue.IsInt()) {
-			return jsonValue.GetInt();
+			if (parseResult.IsError()) {
+				std::cout << "JsonFile.hpp >>>> File: " << fileName << " was not loaded" << std::endl;
+				std::cout << "JsonFile.hpp >>>> Parser Errors: " << rapidjson::GetParseError_En(parseResult.Code()) << std::endl;
+				isFileLoaded = false;
+				return false;
+			}
+			else {
+				std::cout << "JsonFile.hpp >>>> File: " << fileName << " was loaded successfully" << std::endl;
+				isFileLoaded = true;
+				return true;
+			}
 		}
 		else {
-			std::cout << "JsonFile.hpp >>>> value is not an Int" << std::endl;
-			return GetDefaultValue<int>();
+			std::cout << "JsonFile.hpp >>>> File name was not supplied, no file was loaded" << std::endl;
+			isFileLoaded = false;
+			return false;
 		}
 	}
-	template<> inline float GetValue(const rapidjson::Value& jsonValue) {
-		if (jsonValue.IsFloat()) {
-			return jsonValue.GetFloat();
+
+	// Creates the document for a load, in the out-of-core arena when that is enabled. The previous document must already have been deleted
+	rapidjson::Document* NewDocument(void) {
+		outOfCoreAllocator.reset();
+		if (!useOutOfCore) {
+			outOfCoreArena.reset();
+			outOfCoreStackArena.reset();
+			return new rapidjson::Document();
+		}
+		if (outOfCoreArena == nullptr || outOfCoreArena->Capacity() != outOfCoreCapacity || outOfCoreArena->ResidentBudget() != outOfCoreBudget) {
+			outOfCoreArena.reset(new JsonFileArena());
+			if (!outOfCoreArena->Create(outOfCoreFileName, outOfCoreCapacity, outOfCoreBudget)) {
+				std::cout << "JsonFile.hpp >>>> Out-of-core arena could not be created, the document will be loaded onto the heap" << std::endl;
+				outOfCoreArena.reset();
+				return new rapidjson::Document();
+			}
 		}
 		else {
-			std::cout << "JsonFile.hpp >>>> value is not a float" << std::endl;
-			return GetDefaultValue<float>();
+			outOfCoreArena->Release(outOfCoreCapacity);		// Nothing from the last document needs to stay resident
 		}
+		// The stack is as big as the largest container's elements at most, so the document's capacity always covers it
+		if (outOfCoreStackArena == nullptr || outOfCoreStackArena->Capacity() != outOfCoreCapacity || outOfCoreStackArena->ResidentBudget() != outOfCoreBudget) {
+			outOfCoreStackArena.reset(new JsonFileArena());
+			if (!outOfCoreStackArena->Create(outOfCoreFileName + ".stack", outOfCoreCapacity, outOfCoreBudget)) {
+				std::cout << "JsonFile.hpp >>>> Out-of-core parse stack could not be created, it will be kept on the heap" << std::endl;
+				outOfCoreStackArena.reset();
+			}
+		}
+		// The whole arena is the pool's user buffer, so every allocation the document makes lands in the mapped file
+		outOfCoreAllocator.reset(new rapidjson::MemoryPoolAllocator<>(outOfCoreArena->Data(), outOfCoreArena->Capacity()));
+		return new rapidjson::Document(outOfCoreAllocator.get());
 	}
-	template<> inline double GetValue(const rapidjson::Value& jsonValue) {
-		if (jsonValue.IsDouble()) {
-			return jsonValue.GetDouble();
+	const bool IsOutOfCoreDocument(void) const {
+		return jsonDocument != nullptr && outOfCoreAllocator != nullptr && &jsonDocument->GetAllocator() == outOfCoreAllocator.get();
+	}
+	// Writes the document to outFileStream, releasing arena pages as the write goes when the document is out-of-core
+	void WriteWithinBudget(std::ofstream& outFileStream) {
+		rapidjson::OStreamWrapper outputStreamWrapper(outFileStream);
+		if (IsOutOfCoreDocument()) {
+			// Writing walks the whole document, so keep releasing the pages already written out
+			JsonArenaBudgetStream<rapidjson::OStreamWrapper> budgetStream(outputStreamWrapper, *outOfCoreArena, *outOfCoreAllocator);
+			rapidjson::PrettyWriter<JsonArenaBudgetStream<rapidjson::OStreamWrapper>> fileWriter(budgetStream);
+			jsonDocument->Accept(fileWriter);
 		}
 		else {
-			std::cout << "JsonFile.hpp >>>> value is not a double" << std::endl;
-			return GetDefaultValue<double>();
+			rapidjson::PrettyWriter<rapidjson::OStreamWrapper> fileWriter(outputStreamWrapper);
+			jsonDocument->Accept(fileWriter);
 		}
 	}
-	template<> inline std::string GetValue(const rapidjson::Value& jsonValue) {
-		if (jsonValue.IsString()) {
-			return jsonValue.GetString();
+	// An out-of-core document is parsed through one of these, so the parser's stack can live in outOfCoreStackArena rather than on the heap
+	typedef rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::MemoryPoolAllocator<>, rapidjson::MemoryPoolAllocator<>> OutOfCoreParseDocument;
+
+	// ParseIntoDocument(), but releasing arena pages as the parse goes when the document is out-of-core
+	template<typename InputStream> rapidjson::ParseResult ParseWithinBudget(InputStream& inputStream) {
+		if (!IsOutOfCoreDocument()) {
+			return ParseIntoDocument(inputStream, *jsonDocument);
 		}
-		else {
-			std::cout << "JsonFile.hpp >>>> value is not a std::string" << std::endl;
-			return GetDefaultValue<std::string>();
+		std::unique_ptr<rapidjson::MemoryPoolAllocator<>> stackAllocator = NewOutOfCoreStackAllocator();
+		OutOfCoreParseDocument parseDocument(outOfCoreAllocator.get(), kOutOfCoreStackCapacity, stackAllocator.get());
+		JsonArenaBudgetStream<InputStream> budgetStream(inputStream, *outOfCoreArena, *outOfCoreAllocator, outOfCoreStackArena.get(), stackAllocator.get());
+		const rapidjson::ParseResult parseResult = ParseIntoDocument(budgetStream, parseDocument);
+		FinishOutOfCoreParse(parseDocument, stackAllocator.get());
+		return parseResult;
+	}
+	template<typename InputStream> rapidjson::ParseResult ParseWithinBudget(InputStream& inputStream, const JsonSchema& schema, std::vector<JsonSchemaViolation>& violations, const bool& stopOnFirstError) {
+		if (!IsOutOfCoreDocument()) {
+			return ParseIntoDocument(inputStream, *jsonDocument, schema, violations, stopOnFirstError);
 		}
+		std::unique_ptr<rapidjson::MemoryPoolAllocator<>> stackAllocator = NewOutOfCoreStackAllocator();
+		OutOfCoreParseDocument parseDocument(outOfCoreAllocator.get(), kOutOfCoreStackCapacity, stackAllocator.get());
+		JsonArenaBudgetStream<InputStream> budgetStream(inputStream, *outOfCoreArena, *outOfCoreAllocator, outOfCoreStackArena.get(), stackAllocator.get());
+		const rapidjson::ParseResult parseResult = ParseIntoDocument(budgetStream, parseDocument, schema, violations, stopOnFirstError);
+		FinishOutOfCoreParse(parseDocument, stackAllocator.get());
+		return parseResult;
 	}
-	template<> inline bool GetValue(const rapidjson::Value& jsonValue) {
-		if (jsonValue.IsBool()) {
-			return jsonValue.GetBool();
+	static const size_t kOutOfCoreStackCapacity = 1024;	// rapidjson's default, the stack grows in place within its arena
+	// Allocator over the whole stack arena, nullptr leaves the parse document to put its stack on the heap if the arena couldn't be created
+	std::unique_ptr<rapidjson::MemoryPoolAllocator<>> NewOutOfCoreStackAllocator(void) {
+		if (outOfCoreStackArena == nullptr) {
+			return std::unique_ptr<rapidjson::MemoryPoolAllocator<>>();
 		}
-		else {
-			std::cout << "JsonFile.hpp >>>> value is not a boolean" << std::endl;
-			return GetDefaultValue<bool>();
+		return std::unique_ptr<rapidjson::MemoryPoolAllocator<>>(new rapidjson::MemoryPoolAllocator<>(outOfCoreStackArena->Data(), outOfCoreStackArena->Capacity()));
+	}
+	// Moves the parsed root into jsonDocument, both share outOfCoreAllocator so nothing is copied, then drops the pages the parse left resident
+	void FinishOutOfCoreParse(OutOfCoreParseDocument& parseDocument, const rapidjson::MemoryPoolAllocator<>* stackAllocator) {
+		static_cast<rapidjson::Value&>(*jsonDocument).Swap(parseDocument);
+		outOfCoreArena->Release(outOfCoreAllocator->Size());
+		if (stackAllocator != nullptr) {
+			outOfCoreStackArena->Release(stackAllocator->Size());
 		}
 	}
-	
-	// Set value functions, uses Templating overrides to check typing per data type
-	template<typename T> inline bool SetValue(rapidjson::Value& jsonValue, const T& inputValue) {
-		return false;
+
+	// Parses inputStream into targetDocument, going through the string pool if interning is enabled
+	template<typename InputStream, typename Document> rapidjson::ParseResult ParseIntoDocument(InputStream& inputStream, Document& targetDocument) {
+		// The previous document has been deleted by now, so nothing references the old pool
+		stringPool.Clear();
+		if (!useInterning) {
+			targetDocument.ParseStream(inputStream);
+			return rapidjson::ParseResult(targetDocument.GetParseError(), targetDocument.GetErrorOffset());
+		}
+		JsonInterningGenerator<InputStream> interningGenerator(inputStream, stringPool, maxInternedValueLength);
+		targetDocument.Populate(interningGenerator);
+		return interningGenerator.parseResult;
 	}
-	template<> inline bool SetValue(rapidjson::Value& jsonValue, const int& inputValue) {
-		if (jsonValue.IsInt()) {
-			jsonValue.SetInt(inputValue);
-			return true;
+	// As above but validates against schema during the parse, a schema failure when stopOnFirstError is set ends the parse with an error
+	template<typename InputStream, typename Document> rapidjson::ParseResult ParseIntoDocument(InputStream& inputStream, Document& targetDocument, const JsonSchema& schema, std::vector<JsonSchemaViolation>& violations, const bool& stopOnFirstError) {
+		stringPool.Clear();
+		JsonSchemaGenerator<InputStream> schemaGenerator(inputStream, schema, stopOnFirstError, useInterning ? &stringPool : nullptr, maxInternedValueLength);
+		targetDocument.Populate(schemaGenerator);
+		violations = schemaGenerator.violations;
+		return schemaGenerator.parseResult;
+	}
+
+	// Time-sliced loading state, the document is built up separately and only swapped in once it is complete
+	struct TimeSlicedLoad {
+		// A container which has been opened because it was too big to parse in one slice, entries are added to value as they are parsed
+		struct OpenContainer {
+			enum Expecting { FirstEntry, Key, Colon, Value, CommaOrEnd };
+			rapidjson::Value value;
+			rapidjson::Value key;		// Key of the member currently being parsed
+			Expecting expecting = FirstEntry;
+		};
+
+		TimeSlicedLoad(const std::string& fileName, const size_t& sliceUnitBytes) : fileName(fileName), sliceUnitBytes(sliceUnitBytes), document(new rapidjson::Document()) {}
+
+		std::string fileName = "";
+		size_t sliceUnitBytes = 0;
+		std::ifstream fileStream;
+		bool isReadingFile = false;
+		bool isInputFinished = false;
+		std::string buffer = "";		// Text which has been read or fed but not yet discarded
+		size_t bufferPosition = 0;		// Parse position within buffer
+		size_t discardedBytes = 0;		// Bytes parsed and dropped from the front of buffer
+		size_t totalBytes = 0;
+		std::unique_ptr<rapidjson::Document> document;
+		std::vector<std::unique_ptr<OpenContainer>> openContainers;
+		bool isRootComplete = false;
+	};
+	enum class SliceResult { Parsed, NeedsData, Finished, Failed };
+	enum class ScanResult { Complete, NeedsData, TooLarge };
+	std::unique_ptr<TimeSlicedLoad> timeSlicedLoad;
+
+	static size_t ParsedBytes(const TimeSlicedLoad& load) {
+		return load.discardedBytes + load.bufferPosition;
+	}
+	// Drops the parsed text from the front of the buffer so it doesn't grow to the size of the file
+	static void CompactLoadBuffer(TimeSlicedLoad& load) {
+		if (load.bufferPosition > 0) {
+			load.discardedBytes += load.bufferPosition;
+			load.buffer.erase(0, load.bufferPosition);
+			load.bufferPosition = 0;
 		}
-		else {
-			std::cout << "JsonFile.hpp >>>> value is not an Int" << std::endl;
+	}
+	// Reads the next block of a file load, returns false for a fed load or one which has read everything already
+	static bool ReadNextBlock(TimeSlicedLoad& load) {
+		if (!load.isReadingFile || load.isInputFinished) {
 			return false;
 		}
+		CompactLoadBuffer(load);
+		const size_t bufferSize = load.buffer.size();
+		load.buffer.resize(bufferSize + load.sliceUnitBytes);
+		load.fileStream.read(&load.buffer[bufferSize], load.sliceUnitBytes);
+		load.buffer.resize(bufferSize + (size_t)load.fileStream.gcount());
+		if (!load.fileStream.good()) {
+			load.isInputFinished = true;
+		}
+		return true;
 	}
-	template<> inline bool SetValue(rapidjson::Value& jsonValue, const float& inputValue) {
-		if (jsonValue.IsFloat()) {
-			jsonValue.SetFloat(inputValue);
-			return true;
+	// Parses the next token, or whole value if it fits in a slice unit
+	SliceResult ParseNextSlice(TimeSlicedLoad& load) {
+		while (load.bufferPosition < load.buffer.size() && std::isspace((unsigned char)load.buffer[load.bufferPosition])) {
+			load.bufferPosition++;
 		}
-		else {
-			std::cout << "JsonFile.hpp >>>> value is not a Float" << std::endl;
-			return false;
+		if (load.isRootComplete) {
+			if (load.bufferPosition < load.buffer.size()) {
+				return FailTimeSlicedLoad(load, "The document root must not be followed by other values.", ParsedBytes(load));
+			}
+			return load.isInputFinished ? SliceResult::Finished : SliceResult::NeedsData;
 		}
-	}
-	template<> inline bool SetValue(rapidjson::Value& jsonValue, const double& inputValue) {
-		if (jsonValue.IsDouble()) {
-			jsonValue.SetDouble(inputValue);
-			return true;
+		if (load.bufferPosition >= load.buffer.size()) {
+			return load.isInputFinished ? FailTimeSlicedLoad(load, "The text ended before the document was complete.", ParsedBytes(load)) : SliceResult::NeedsData;
 		}
-		else {
-			std::cout << "JsonFile.hpp >>>> value is not a Double" << std::endl;
-			return false;
+		if (load.openContainers.empty()) {
+			return ParseSliceValue(load);
+		}
+
+		TimeSlicedLoad::OpenContainer& openContainer = *load.openContainers.back();
+		const char nextChar = load.buffer[load.bufferPosition];
+		const char closingChar = openContainer.value.IsObject() ? '}' : ']';
+		switch (openContainer.expecting) {
+		case TimeSlicedLoad::OpenContainer::FirstEntry:
+			if (nextChar == closingChar) {
+				return CloseSliceContainer(load);
+			}
+			openContainer.expecting = openContainer.value.IsObject() ? TimeSlicedLoad::OpenContainer::Key : TimeSlicedLoad::OpenContainer::Value;
+			return SliceResult::Parsed;
+		case TimeSlicedLoad::OpenContainer::Key:
+			if (nextChar != '"') {
+				return FailTimeSlicedLoad(load, "Missing a name for object member.", ParsedBytes(load));
+			}
+			return ParseSliceValue(load);
+		case TimeSlicedLoad::OpenContainer::Colon:
+			if (nextChar != ':') {
+				return FailTimeSlicedLoad(load, "Missing a colon after a name of object member.", ParsedBytes(load));
+			}
+			load.bufferPosition++;
+			openContainer.expecting = TimeSlicedLoad::OpenContainer::Value;
+			return SliceResult::Parsed;
+		case TimeSlicedLoad::OpenContainer::Value:
+			return ParseSliceValue(load);
+		case TimeSlicedLoad::OpenContainer::CommaOrEnd:
+			if (nextChar == closingChar) {
+				return CloseSliceContainer(load);
+			}
+			if (nextChar != ',') {
+				return FailTimeSlicedLoad(load, "Missing a comma or a closing bracket after an entry.", ParsedBytes(load));
+			}
+			load.bufferPosition++;
+			openContainer.expecting = openContainer.value.IsObject() ? TimeSlicedLoad::OpenContainer::Key : TimeSlicedLoad::OpenContainer::Value;
+			return SliceResult::Parsed;
 		}
+		return SliceResult::Failed;
 	}
-	template<> inline bool SetValue(rapidjson::Value& jsonValue, const std::string& inputValue) {
-		if (jsonValue.IsString()) {
-			jsonValue.SetString(inputValue.c_str(), (rapidjson::SizeType)inputValue.length(), jsonDocument->GetAllocator());
-			return true;
+	// Parses the value (or member name) at the parse position, opening it up instead if it is a container too big for one slice
+	SliceResult ParseSliceValue(TimeSlicedLoad& load) {
+		size_t valueLength = 0;
+		const ScanResult scanResult = ScanSliceValue(load, valueLength);
+		if (scanResult == ScanResult::NeedsData) {
+			return load.isInputFinished ? FailTimeSlicedLoad(load, "The text ended before the document was complete.", ParsedBytes(load)) : SliceResult::NeedsData;
 		}
-		else {
-			std::cout << "JsonFile.hpp >>>> value is not a String" << std::endl;
-			return false;
+		if (scanResult == ScanResult::TooLarge) {
+			std::unique_ptr<TimeSlicedLoad::OpenContainer> openContainer(new TimeSlicedLoad::OpenContainer());
+			if (load.buffer[load.bufferPosition] == '{') {
+				openContainer->value.SetObject();
+			}
+			else {
+				openContainer->value.SetArray();
+			}
+			load.openContainers.push_back(std::move(openContainer));
+			load.bufferPosition++;
+			return SliceResult::Parsed;
 		}
-	}
-	template<> inline bool SetValue(rapidjson::Value& jsonValue, const bool& inputValue) {
-		if (jsonValue.IsBool()) {
-			jsonValue.SetBool(inputValue);
-			return true;
+		if (valueLength == 0) {
+			return FailTimeSlicedLoad(load, "Invalid value.", ParsedBytes(load));
 		}
-		else {
-			std::cout << "JsonFile.hpp >>>> value is not a Boolean" << std::endl;
-			return false;
+		// The value's memory comes from the new document's allocator, so it can be moved straight into place
+		rapidjson::Document sliceDocument(&load.document->GetAllocator());
+		sliceDocument.Parse(load.buffer.data() + load.bufferPosition, valueLength);
+		if (sliceDocument.HasParseError()) {
+			return FailTimeSlicedLoad(load, rapidjson::GetParseError_En(sliceDocument.GetParseError()), ParsedBytes(load) + sliceDocument.GetErrorOffset());
 		}
+		load.bufferPosition += valueLength;
+		if (!load.openContainers.empty() && load.openContainers.back()->expecting == TimeSlicedLoad::OpenContainer::Key) {
+			if (!sliceDocument.IsString()) {
+				return FailTimeSlicedLoad(load, "Missing a name for object member.", ParsedBytes(load) - valueLength);
+			}
+			load.openContainers.back()->key.Swap(sliceDocument);
+			load.openContainers.back()->expecting = TimeSlicedLoad::OpenContainer::Colon;
+			return SliceResult::Parsed;
+		}
+		AddSliceValue(load, sliceDocument);
+		return SliceResult::Parsed;
 	}
-	
-	// Set Array functions, uses templating to get round issues with std::string
+	// Finds the length of the value at the parse position, stops scanning containers once they are bigger than a slice unit
+	static ScanResult ScanSliceValue(const TimeSlicedLoad& load, size_t& valueLength) {
+		const char* valueText = load.buffer.data() + load.bufferPosition;
+		const size_t availableBytes = load.buffer.size() - load.bufferPosition;
+		const char firstChar = valueText[0];
+		if (firstChar == '{' || firstChar == '[') {
+			size_t depth = 0;
+			bool isInString = false;
+			for (size_t i = 0; i < availableBytes; i++) {
+				if (i >= load.sliceUnitBytes) {
+					return ScanResult::TooLarge;
+				}
+				const char currentChar = valueText[i];
+				if (isInString) {
+					if (currentChar == '\\') {
+						i++;
+					}
+					else if (currentChar == '"') {
+						isInString = false;
+					}
+				}
+				else if (currentChar == '"') {
+					isInString = true;
+				}
+				else if (currentChar == '{' || currentChar == '[') {
+					depth++;
+				}
+				else if (currentChar == '}' || currentChar == ']') {
+					depth--;
+					if (depth == 0) {
+						valueLength = i + 1;
+						return ScanResult::Complete;
+					}
+				}
+			}
+			return ScanResult::NeedsData;
+		}
+		if (firstChar == '"') {
+			for (size_t i = 1; i < availableBytes; i++) {
+				if (valueText[i] == '\\') {
+					i++;
+				}
+				else if (valueText[i] == '"') {
+					valueLength = i + 1;
+					return ScanResult::Complete;
+				}
+			}
+			return ScanResult::NeedsData;
+		}
+		// Numbers and literals run until the next delimiter, which might not have arrived yet
+		size_t i = 0;
+		while (i < availableBytes && std::strchr(",]}: \t\r\n", valueText[i]) == nullptr) {
+			i++;
+		}
+		if (i == availableBytes && !load.isInputFinished) {
+			return ScanResult::NeedsData;
+		}
+		valueLength = i;
+		return ScanResult::Complete;
+	}
+	// Moves a parsed value into the innermost open container, or makes it the root if every container has been closed
+	static void AddSliceValue(TimeSlicedLoad& load, rapidjson::Value& parsedValue) {
+		if (load.openContainers.empty()) {
+			static_cast<rapidjson::Value&>(*load.document).Swap(parsedValue);
+			load.isRootComplete = true;
+			return;
+		}
+		TimeSlicedLoad::OpenContainer& openContainer = *load.openContainers.back();
+		if (openContainer.value.IsObject()) {
+			openContainer.value.AddMember(openContainer.key, parsedValue, load.document->GetAllocator());
+		}
+		else {
+			openContainer.value.PushBack(parsedValue, load.document->GetAllocator());
+		}
+		openContainer.expecting = TimeSlicedLoad::OpenContainer::CommaOrEnd;
+	}
+	static SliceResult CloseSliceContainer(TimeSlicedLoad& load) {
+		load.bufferPosition++;
+		std::unique_ptr<TimeSlicedLoad::OpenContainer> closedContainer = std::move(load.openContainers.back());
+		load.openContainers.pop_back();
+		AddSliceValue(load, closedContainer->value);
+		return SliceResult::Parsed;
+	}
+	static SliceResult FailTimeSlicedLoad(const TimeSlicedLoad& load, const char* parseError, const size_t& errorOffset) {
+		std::cout << "JsonFile.hpp >>>> File: " << load.fileName << " was not loaded" << std::endl;
+		std::cout << "JsonFile.hpp >>>> Parser Errors: " << parseError << " at offset " << errorOffset << std::endl;
+		return SliceResult::Failed;
+	}
+	// Swaps the finished document in, this is the only part of a time-sliced load which touches the current document
+	void CompleteTimeSlicedLoad(void) {
+		std::unique_ptr<TimeSlicedLoad> completedLoad = std::move(timeSlicedLoad);
+		Flush();
+		DocumentLock documentLock(*this);
+		ClearHistory();
+		if (jsonDocument != nullptr) {
+			delete jsonDocument;
+		}
+		parallelChunks.clear();
+		stringPool.Clear();
+		jsonDocument = completedLoad->document.release();
+		fileName = completedLoad->fileName;
+		isArchiveEntry = false;
+		isFileLoaded = true;
+		StampChange(std::vector<std::string>());
+		std::cout << "JsonFile.hpp >>>> File: " << fileName << " was loaded successfully" << std::endl;
+	}
+
+	// Parses text into jsonDocument, parsing its largest array on several threads if it is big enough.
+	// Anything unexpected, including a syntax error, falls back to a normal parse so errors are reported against the original text
+	rapidjson::ParseResult ParseInParallel(const char* text, const size_t& textSize) {
+		stringPool.Clear();
+		size_t arrayStart = 0;
+		size_t arrayEnd = 0;
+		std::vector<size_t> elementSeparators;
+		const size_t threadCount = (parallelThreadCount != 0) ? parallelThreadCount : std::thread::hardware_concurrency();
+		if (threadCount > 1 && FindLargestArray(text, textSize, arrayStart, arrayEnd) && arrayEnd - arrayStart >= parallelMinimumArrayBytes && FindElementSeparators(text, arrayStart, arrayEnd, elementSeparators)) {
+			// Group the elements into one contiguous range per thread, cutting at the separator nearest each share of the bytes
+			std::vector<std::pair<size_t, size_t>> chunkRanges;
+			const size_t targetChunkSize = (arrayEnd - arrayStart) / threadCount + 1;
+			size_t chunkStart = arrayStart + 1;
+			for (const size_t& separator : elementSeparators) {
+				if (separator - chunkStart >= targetChunkSize) {
+					chunkRanges.push_back(std::make_pair(chunkStart, separator));
+					chunkStart = separator + 1;
+				}
+			}
+			chunkRanges.push_back(std::make_pair(chunkStart, arrayEnd));
+
+			// Each thread parses its own range, wrapped back up as an array, into a document with its own allocator.
+			// The brackets are spliced in by the stream, so the ranges are read straight out of text rather than copied
+			std::vector<std::unique_ptr<rapidjson::Document>> chunkDocuments(chunkRanges.size());
+			std::vector<std::thread> chunkThreads;
+			for (size_t i = 0; i < chunkRanges.size(); i++) {
+				chunkThreads.push_back(std::thread([&chunkDocuments, &chunkRanges, text, i]() {
+					SplicedTextStream chunkStream("[", 1, text + chunkRanges[i].first, chunkRanges[i].second - chunkRanges[i].first, "]", 1);
+					chunkDocuments[i].reset(new rapidjson::Document());
+					chunkDocuments[i]->ParseStream(chunkStream);
+				}));
+			}
+			// The rest of the document is parsed on this thread with the array swapped for a placeholder
+			SplicedTextStream documentStream(text, arrayStart, ParallelPlaceholder(), std::strlen(ParallelPlaceholder()), text + arrayEnd + 1, textSize - arrayEnd - 1);
+			jsonDocument->ParseStream(documentStream);
+			for (std::thread& chunkThread : chunkThreads) {
+				chunkThread.join();
+			}
+
+			// A trailing comma leaves the last range empty, which would otherwise parse as an empty array
+			bool isParsed = !jsonDocument->HasParseError() && !IsWhitespace(text, chunkRanges.back().first, chunkRanges.back().second);
+			size_t numberOfElements = 0;
+			for (const std::unique_ptr<rapidjson::Document>& chunkDocument : chunkDocuments) {
+				isParsed = isParsed && !chunkDocument->HasParseError();
+				numberOfElements += chunkDocument->IsArray() ? chunkDocument->Size() : 0;
+			}
+			rapidjson::Value* placeholderValue = isParsed ? FindParallelPlaceholder(*jsonDocument) : nullptr;
+			if (placeholderValue != nullptr) {
+				// Move the parsed elements into the array, they keep pointing into their chunk's allocator so the chunks are kept alive with the document
+				placeholderValue->SetArray();
+				placeholderValue->Reserve((rapidjson::SizeType)numberOfElements, jsonDocument->GetAllocator());
+				for (std::unique_ptr<rapidjson::Document>& chunkDocument : chunkDocuments) {
+					for (rapidjson::Value::ValueIterator element = chunkDocument->Begin(); element != chunkDocument->End(); ++element) {
+						placeholderValue->PushBack(*element, jsonDocument->GetAllocator());
+					}
+					parallelChunks.push_back(std::move(chunkDocument));
+				}
+				return rapidjson::ParseResult();
+			}
+		}
+		jsonDocument->Parse(text, textSize);
+		return rapidjson::ParseResult(jsonDocument->GetParseError(), jsonDocument->GetErrorOffset());
+	}
+	// Finds the longest array in text, arrayStart and arrayEnd are the offsets of its brackets. Returns false if the brackets don't match up
+	static bool FindLargestArray(const char* text, const size_t& textSize, size_t& arrayStart, size_t& arrayEnd) {
+		std::vector<size_t> openContainers;
+		bool isInString = false;
+		bool isFound = false;
+		for (size_t i = 0; i < textSize; i++) {
+			const char currentChar = text[i];
+			if (isInString) {
+				if (currentChar == '\\') {
+					i++;
+				}
+				else if (currentChar == '"') {
+					isInString = false;
+				}
+			}
+			else if (currentChar == '"') {
+				isInString = true;
+			}
+			else if (currentChar == '[' || currentChar == '{') {
+				openContainers.push_back(i);
+			}
+			else if (currentChar == ']' || currentChar == '}') {
+				if (openContainers.empty() || text[openContainers.back()] != ((currentChar == ']') ? '[' : '{')) {
+					return false;
+				}
+				if (currentChar == ']' && (!isFound || i - openContainers.back() > arrayEnd - arrayStart)) {
+					arrayStart = openContainers.back();
+					arrayEnd = i;
+					isFound = true;
+				}
+				openContainers.pop_back();
+			}
+		}
+		return isFound && openContainers.empty();
+	}
+	// Fills elementSeparators with the offsets of the commas between the array's elements, returns false if it has less than two elements
+	static bool FindElementSeparators(const char* text, const size_t& arrayStart, const size_t& arrayEnd, std::vector<size_t>& elementSeparators) {
+		size_t depth = 0;
+		bool isInString = false;
+		for (size_t i = arrayStart + 1; i < arrayEnd; i++) {
+			const char currentChar = text[i];
+			if (isInString) {
+				if (currentChar == '\\') {
+					i++;
+				}
+				else if (currentChar == '"') {
+					isInString = false;
+				}
+			}
+			else if (currentChar == '"') {
+				isInString = true;
+			}
+			else if (currentChar == '[' || currentChar == '{') {
+				depth++;
+			}
+			else if (currentChar == ']' || currentChar == '}') {
+				depth--;
+			}
+			else if (currentChar == ',' && depth == 0) {
+				elementSeparators.push_back(i);
+			}
+		}
+		return !elementSeparators.empty();
+	}
+	// True if the range of text holds nothing but JSON whitespace
+	static bool IsWhitespace(const char* text, const size_t& rangeStart, const size_t& rangeEnd) {
+		for (size_t i = rangeStart; i < rangeEnd; i++) {
+			if (text[i] != ' ' && text[i] != '\t' && text[i] != '\n' && text[i] != '\r') {
+				return false;
+			}
+		}
+		return true;
+	}
+	// Read-only rapidjson input stream over up to three pieces of text back to back, so ParseInParallel() can parse parts of the file without copying them
+	class SplicedTextStream {
+	public:
+		typedef char Ch;
+
+		SplicedTextStream(const char* firstText, const size_t& firstSize, const char* secondText, const size_t& secondSize, const char* thirdText, const size_t& thirdSize) {
+			pieces[0] = std::make_pair(firstText, firstSize);
+			pieces[1] = std::make_pair(secondText, secondSize);
+			pieces[2] = std::make_pair(thirdText, thirdSize);
+			pieceIndex = (size_t)-1;
+			NextPiece();
+		}
+
+		Ch Peek(void) const {
+			return (current != nullptr) ? *current : '\0';
+		}
+		Ch Take(void) {
+			if (current == nullptr) {
+				return '\0';
+			}
+			const Ch takenChar = *current;
+			position++;
+			if (++current == pieceEnd) {
+				NextPiece();
+			}
+			return takenChar;
+		}
+		size_t Tell(void) const {
+			return position;
+		}
+		// Only parsed from, never written to
+		Ch* PutBegin(void) {
+			RAPIDJSON_ASSERT(false);
+			return nullptr;
+		}
+		void Put(Ch) {
+			RAPIDJSON_ASSERT(false);
+		}
+		void Flush(void) {
+			RAPIDJSON_ASSERT(false);
+		}
+		size_t PutEnd(Ch*) {
+			RAPIDJSON_ASSERT(false);
+			return 0;
+		}
+
+	private:
+		std::pair<const char*, size_t> pieces[3];
+		size_t pieceIndex = 0;
+		const Ch* current = nullptr;	// nullptr once every piece has been read
+		const Ch* pieceEnd = nullptr;
+		size_t position = 0;
+
+		// Moves to the next non-empty piece
+		void NextPiece(void) {
+			current = nullptr;
+			while (++pieceIndex < 3) {
+				if (pieces[pieceIndex].second > 0) {
+					current = pieces[pieceIndex].first;
+					pieceEnd = current + pieces[pieceIndex].second;
+					return;
+				}
+			}
+		}
+	};
+	// String the parallel array is swapped for while the rest of the document is parsed, the leading null can't appear in a content file's keys or values
+	static const char* ParallelPlaceholder(void) {
+		return "\"\\u0000@parallel-array\"";
+	}
+	// Walks the document for the placeholder left by ParseInParallel(), the document is small once the array has been cut out of it
+	rapidjson::Value* FindParallelPlaceholder(rapidjson::Value& jsonValue) {
+		static const char placeholderText[] = "\0@parallel-array";
+		if (jsonValue.IsString()) {
+			const bool isPlaceholder = jsonValue.GetStringLength() == sizeof(placeholderText) - 1 && std::memcmp(jsonValue.GetString(), placeholderText, sizeof(placeholderText) - 1) == 0;
+			return isPlaceholder ? &jsonValue : nullptr;
+		}
+		if (jsonValue.IsObject()) {
+			for (rapidjson::Value::MemberIterator member = jsonValue.MemberBegin(); member != jsonValue.MemberEnd(); ++member) {
+				rapidjson::Value* placeholderValue = FindParallelPlaceholder(member->value);
+				if (placeholderValue != nullptr) {
+					return placeholderValue;
+				}
+			}
+		}
+		else if (jsonValue.IsArray()) {
+			for (rapidjson::Value::ValueIterator element = jsonValue.Begin(); element != jsonValue.End(); ++element) {
+				rapidjson::Value* placeholderValue = FindParallelPlaceholder(*element);
+				if (placeholderValue != nullptr) {
+					return placeholderValue;
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	// Fills keyValue with keyName, referencing the pooled copy if interning is enabled
+	void SetKeyValue(rapidjson::Value& keyValue, const std::string& keyName) {
+		if (useInterning && keyName.length() > JsonStringPool::kInlineStringLength) {
+			keyValue.SetString(rapidjson::StringRef(stringPool.Intern(keyName.c_str(), keyName.length()), (rapidjson::SizeType)keyName.length()));
+		}
+		else {
+			keyValue.SetString(keyName.c_str(), (rapidjson::SizeType)keyName.length(), jsonDocument->GetAllocator());
+		}
+	}
+
+	// A single journalled edit, before is null for an insert and after is null for a removal. Both sides live in historyAllocator
+	struct HistoryEntry {
+		std::vector<std::string> path;
+		const rapidjson::Value* before = nullptr;
+		const rapidjson::Value* after = nullptr;
+	};
+	// The history allocator is rebuilt from the live entries once it holds this much more than it did after the last rebuild
+	static const size_t kHistoryCompactionSlack = 64 * 1024;
+	std::deque<HistoryEntry> history;
+	std::unique_ptr<rapidjson::MemoryPoolAllocator<>> historyAllocator{ new rapidjson::MemoryPoolAllocator<>() };	// Shared by every entry, pool allocators can't free single copies so trimmed ones are reclaimed by CompactHistory()
+	size_t compactedHistoryBytes = 0;	// historyAllocator's size after the last rebuild
+	size_t historyLimit = 0;		// 0 disables the history
+	size_t historyPosition = 0;		// Number of entries currently applied, anything past this can be redone
+	size_t historyBaseVersion = 0;	// Snapshot id of the state before history[0]
+
+	// Copies a node into the history allocator, returns nullptr when history is disabled
+	rapidjson::Value* CopyForHistory(const rapidjson::Value& jsonValue) {
+		if (historyLimit == 0) {
+			return nullptr;
+		}
+		return CopyIntoAllocator(jsonValue, *historyAllocator);
+	}
+	static rapidjson::Value* CopyIntoAllocator(const rapidjson::Value& jsonValue, rapidjson::MemoryPoolAllocator<>& allocator) {
+		// Pool allocated values are never destructed, so the value itself can live in the pool alongside its contents
+		return new (allocator.Malloc(sizeof(rapidjson::Value))) rapidjson::Value(jsonValue, allocator);
+	}
+	// Journals an edit to objectName, after is the node's new value or nullptr if it was removed
+	// Every edit comes through here, so it also stamps the edit for change tracking
+	void RecordHistory(const std::string& objectName, const rapidjson::Value* before, const rapidjson::Value* after) {
+		const std::vector<std::string> path = CanonicalPath(SplitString(objectName, '.'));
+		StampEdit(path, after == nullptr);
+		if (historyLimit == 0) {
+			return;
+		}
+		// A new edit drops anything that could have been redone
+		history.erase(history.begin() + historyPosition, history.end());
+		HistoryEntry entry;
+		entry.path = path;
+		entry.before = before;
+		if (after != nullptr) {
+			entry.after = CopyForHistory(*after);
+		}
+		history.push_back(std::move(entry));
+		historyPosition++;
+		TrimHistory();
+	}
+	void RecordInsertHistory(const std::string& positionToInsert, const std::string& keyName, const rapidjson::Value& insertedInto) {
+		const rapidjson::Value* insertedValue = FindChildValue(insertedInto, keyName);
+		RecordHistory((positionToInsert != "") ? positionToInsert + "." + keyName : keyName, nullptr, insertedValue);
+	}
+	// Drops entries once we're over the limit, anything that could be redone goes first so historyPosition never passes the front
+	void TrimHistory(void) {
+		while (history.size() > historyLimit && history.size() > historyPosition) {
+			history.pop_back();
+		}
+		while (history.size() > historyLimit) {
+			history.pop_front();
+			historyBaseVersion++;
+			historyPosition--;
+		}
+		CompactHistory();
+	}
+	// Forgets every entry, snapshots taken before this can no longer be restored
+	void ClearHistory(void) {
+		historyBaseVersion += history.size() + 1;
+		history.clear();
+		historyPosition = 0;
+		CompactHistory();
+	}
+	// Copies the live entries into a fresh allocator once dropped ones, or copies of edits that failed, make up most of the current one.
+	// Rebuilding only after the allocator doubles keeps the cost per journalled byte constant
+	void CompactHistory(void) {
+		if (history.empty()) {
+			historyAllocator->Clear();
+			compactedHistoryBytes = 0;
+			return;
+		}
+		if (historyAllocator->Size() <= compactedHistoryBytes * 2 + kHistoryCompactionSlack) {
+			return;
+		}
+		std::unique_ptr<rapidjson::MemoryPoolAllocator<>> compactedAllocator(new rapidjson::MemoryPoolAllocator<>());
+		for (HistoryEntry& entry : history) {
+			if (entry.before != nullptr) {
+				entry.before = CopyIntoAllocator(*entry.before, *compactedAllocator);
+			}
+			if (entry.after != nullptr) {
+				entry.after = CopyIntoAllocator(*entry.after, *compactedAllocator);
+			}
+		}
+		historyAllocator.swap(compactedAllocator);
+		compactedHistoryBytes = historyAllocator->Size();
+	}
+	// Applies one side of a journalled edit, undo puts the before value back and redo the after value.
+	// A missing node is inserted and a null side removes the node
+	void ApplyHistoryEntry(const HistoryEntry& entry, const bool& isUndo) {
+		const rapidjson::Value* jsonValue = isUndo ? entry.before : entry.after;
+		const bool isReplace = (entry.before != nullptr && entry.after != nullptr);
+		const std::vector<std::string> parentPath(entry.path.begin(), entry.path.end() - 1);
+		// The journal only ever addresses our own document, so casting away the lookup's const is safe
+		rapidjson::Value* parentValue = const_cast<rapidjson::Value*>(FindRelativeValue(*jsonDocument, parentPath));
+		if (parentValue == nullptr) {
+			return;
+		}
+		StampEdit(entry.path, !isReplace);
+		const std::string& key = entry.path.back();
+		if (parentValue->IsObject()) {
+			rapidjson::Value::MemberIterator member = parentValue->FindMember(key.c_str());
+			if (jsonValue == nullptr) {
+				if (member != parentValue->MemberEnd()) {
+					parentValue->EraseMember(member);
+				}
+			}
+			else if (member != parentValue->MemberEnd()) {
+				member->value.CopyFrom(*jsonValue, jsonDocument->GetAllocator());
+			}
+			else {
+				rapidjson::Value newKey;
+				SetKeyValue(newKey, key);
+				rapidjson::Value newValue(*jsonValue, jsonDocument->GetAllocator());
+				parentValue->AddMember(newKey, newValue, jsonDocument->GetAllocator());
+			}
+		}
+		else if (parentValue->IsArray()) {
+			const size_t indexOfValue = std::stoul(key);
+			const size_t arraySize = parentValue->Size();
+			if (jsonValue == nullptr) {
+				if (indexOfValue < arraySize) {
+					parentValue->Erase(parentValue->Begin() + indexOfValue);
+				}
+			}
+			else if (isReplace && indexOfValue < arraySize) {
+				(*parentValue)[(rapidjson::SizeType)indexOfValue].CopyFrom(*jsonValue, jsonDocument->GetAllocator());
+			}
+			else {
+				// Undoing a removal, push the value on the end then swap it down into its old slot
+				rapidjson::Value newValue(*jsonValue, jsonDocument->GetAllocator());
+				parentValue->PushBack(newValue, jsonDocument->GetAllocator());
+				for (size_t i = parentValue->Size() - 1; i > indexOfValue; i--) {
+					(*parentValue)[(rapidjson::SizeType)i].Swap((*parentValue)[(rapidjson::SizeType)(i - 1)]);
+				}
+			}
+		}
+	}
+
+	// Change tracking state, a trie of the paths that have been changed holding the version of the last change at or below each node
+	struct VersionNode {
+		size_t version = 0;
+		size_t replacedVersion = 0;		// Last time the node itself was replaced, its children's stamps are dropped at that point
+		std::map<std::string, std::unique_ptr<VersionNode>> children;
+	};
+	struct Subscription {
+		size_t id = 0;
+		std::vector<std::string> prefix;
+		ChangeCallback callback;
+	};
+	struct PendingNotification {
+		ChangeCallback callback;
+		std::string changedPath;
+		size_t version;
+	};
+	VersionNode versionRoot;
+	size_t documentVersion = 0;
+	std::vector<Subscription> subscriptions;
+	size_t nextSubscriptionId = 1;
+	std::vector<PendingNotification> pendingNotifications;	// Queued while the document is locked, sent by ~DocumentLock()
+
+	// Stamps a change to the node at path with a new version, replacing everything below it
+	void StampChange(const std::vector<std::string>& path) {
+		const size_t changeVersion = ++documentVersion;
+		VersionNode* versionNode = &versionRoot;
+		versionNode->version = changeVersion;
+		for (const std::string& key : path) {
+			std::unique_ptr<VersionNode>& child = versionNode->children[key];
+			if (child == nullptr) {
+				child.reset(new VersionNode());
+			}
+			versionNode = child.get();
+			versionNode->version = changeVersion;
+		}
+		versionNode->replacedVersion = changeVersion;
+		versionNode->children.clear();
+		InvalidateHashes(path);
+
+		// Queue up every subscriber whose prefix is on the changed path, or underneath it
+		for (const Subscription& subscription : subscriptions) {
+			const size_t sharedLength = (subscription.prefix.size() < path.size()) ? subscription.prefix.size() : path.size();
+			if (std::equal(path.begin(), path.begin() + sharedLength, subscription.prefix.begin())) {
+				PendingNotification notification;
+				notification.callback = subscription.callback;
+				notification.changedPath = JoinPath(path);
+				notification.version = changeVersion;
+				pendingNotifications.push_back(notification);
+			}
+		}
+	}
+	// Hashing state, a trie of the containers which have been hashed since they last changed
+	struct HashNode {
+		uint64_t hash = 0;
+		bool isValid = false;
+		std::map<std::string, std::unique_ptr<HashNode>> children;
+	};
+	bool useHashing = false;
+	HashNode hashRoot;
+
+	bool TryHashOf(const std::string& path, uint64_t& hash) {
+		std::lock_guard<std::mutex> documentLock(documentMutex);
+		if (!isFileLoaded) {
+			std::cout << "JsonFile.hpp >>>> File is not loaded, cannot call HashOf()" << std::endl;
+			return false;
+		}
+		const std::vector<std::string> splitPath = SplitString(path, '.');
+		const rapidjson::Value* jsonValue = FindRelativeValue(*jsonDocument, splitPath);
+		if (jsonValue == nullptr) {
+			std::cout << "JsonFile.hpp >>>> Could not find key: " << path << std::endl;
+			return false;
+		}
+		HashNode* hashNode = nullptr;
+		if (useHashing) {
+			hashNode = &hashRoot;
+			for (const std::string& key : CanonicalPath(splitPath)) {
+				hashNode = ChildHashNode(hashNode, key);
+			}
+		}
+		hash = HashValue(*jsonValue, hashNode);
+		return true;
+	}
+	// Hashes jsonValue, reusing and filling in hashNode's cached hashes when it is given
+	uint64_t HashValue(const rapidjson::Value& jsonValue, HashNode* hashNode) {
+		if (hashNode != nullptr && hashNode->isValid) {
+			return hashNode->hash;
+		}
+		uint64_t hash = 0;
+		if (jsonValue.IsObject()) {
+			// Members are summed so the order they appear in doesn't matter
+			uint64_t memberSum = 0;
+			for (rapidjson::Value::ConstMemberIterator member = jsonValue.MemberBegin(); member != jsonValue.MemberEnd(); ++member) {
+				const uint64_t keyHash = HashBytes(member->name.GetString(), member->name.GetStringLength(), kHashSeed);
+				HashNode* childNode = IsCachedInHashTrie(hashNode, member->value) ? ChildHashNode(hashNode, std::string(member->name.GetString(), member->name.GetStringLength())) : nullptr;
+				memberSum += MixHash(keyHash ^ HashValue(member->value, childNode));
+			}
+			hash = MixHash(memberSum + jsonValue.MemberCount() + 1);
+		}
+		else if (jsonValue.IsArray()) {
+			hash = MixHash(jsonValue.Size() + 2);
+			const rapidjson::SizeType arraySize = jsonValue.Size();
+			for (rapidjson::SizeType i = 0; i < arraySize; i++) {
+				const rapidjson::Value& element = jsonValue[i];
+				HashNode* childNode = IsCachedInHashTrie(hashNode, element) ? ChildHashNode(hashNode, std::to_string(i)) : nullptr;
+				hash = MixHash(hash ^ HashValue(element, childNode));
+			}
+		}
+		else if (jsonValue.IsString()) {
+			hash = HashBytes(jsonValue.GetString(), jsonValue.GetStringLength(), kHashSeed + 3);
+		}
+		else if (jsonValue.IsInt64()) {
+			hash = MixHash((uint64_t)jsonValue.GetInt64() + kHashSeed + 4);
+		}
+		else if (jsonValue.IsUint64()) {
+			hash = MixHash(jsonValue.GetUint64() + kHashSeed + 5);
+		}
+		else if (jsonValue.IsDouble()) {
+			const double doubleValue = jsonValue.GetDouble();
+			uint64_t doubleBits = 0;
+			std::memcpy(&doubleBits, &doubleValue, sizeof(doubleBits));
+			hash = MixHash(doubleBits + kHashSeed + 6);
+		}
+		else if (jsonValue.IsBool()) {
+			hash = MixHash(jsonValue.GetBool() ? kHashSeed + 7 : kHashSeed + 8);
+		}
+		else {
+			hash = MixHash(kHashSeed + 9);
+		}
+		if (hashNode != nullptr) {
+			hashNode->hash = hash;
+			hashNode->isValid = true;
+		}
+		return hash;
+	}
+	// Only containers get a node of their own when we're caching, scalars are cheap enough to hash every time
+	static bool IsCachedInHashTrie(const HashNode* hashNode, const rapidjson::Value& childValue) {
+		return hashNode != nullptr && (childValue.IsObject() || childValue.IsArray());
+	}
+	HashNode* ChildHashNode(HashNode* hashNode, const std::string& key) {
+		std::unique_ptr<HashNode>& child = hashNode->children[key];
+		if (child == nullptr) {
+			child.reset(new HashNode());
+		}
+		return child.get();
+	}
+	// Drops the cached hashes of path and everything above it, and forgets everything below it
+	void InvalidateHashes(const std::vector<std::string>& path) {
+		HashNode* hashNode = &hashRoot;
+		hashNode->isValid = false;
+		for (const std::string& key : path) {
+			std::map<std::string, std::unique_ptr<HashNode>>::iterator child = hashNode->children.find(key);
+			if (child == hashNode->children.end()) {
+				return;
+			}
+			hashNode = child->second.get();
+			hashNode->isValid = false;
+		}
+		hashNode->children.clear();
+	}
+	void ClearHashes(void) {
+		hashRoot.children.clear();
+		hashRoot.isValid = false;
+	}
+	static const uint64_t kHashSeed = 0x9E3779B97F4A7C15ull;
+	// FNV-1a over the bytes, finished with MixHash() so short strings still spread over all 64 bits
+	static uint64_t HashBytes(const char* data, const size_t& size, uint64_t seed) {
+		uint64_t hash = 0xCBF29CE484222325ull ^ seed;
+		for (size_t i = 0; i < size; i++) {
+			hash ^= (unsigned char)data[i];
+			hash *= 0x100000001B3ull;
+		}
+		return MixHash(hash);
+	}
+	// SplitMix64 finaliser
+	static uint64_t MixHash(uint64_t hash) {
+		hash ^= hash >> 30;
+		hash *= 0xBF58476D1CE4E5B9ull;
+		hash ^= hash >> 27;
+		hash *= 0x94D049BB133111EBull;
+		hash ^= hash >> 31;
+		return hash;
+	}
+
+	// Stamps an edit made to path, inserting or removing an array element shifts its siblings so the whole array is stamped instead
+	void StampEdit(const std::vector<std::string>& path, const bool& isInsertOrRemove) {
+		if (isInsertOrRemove && !path.empty()) {
+			const std::vector<std::string> parentPath(path.begin(), path.end() - 1);
+			const rapidjson::Value* parentValue = FindRelativeValue(*jsonDocument, parentPath);
+			if (parentValue != nullptr && parentValue->IsArray()) {
+				StampChange(parentPath);
+				return;
+			}
+		}
+		StampChange(path);
+	}
+	// Rewrites every segment which indexes an array as the plain index it resolves to, so "01" or "1abc" key the tries the same as "1".
+	// Object keys are left alone, as is everything below the first segment that doesn't exist in the document
+	std::vector<std::string> CanonicalPath(const std::vector<std::string>& path) {
+		std::vector<std::string> canonicalPath(path);
+		const rapidjson::Value* jsonValue = jsonDocument;
+		for (std::string& key : canonicalPath) {
+			if (jsonValue == nullptr) {
+				break;
+			}
+			if (!jsonValue->IsArray()) {
+				jsonValue = FindChildValue(*jsonValue, key);
+				continue;
+			}
+			// Parsed as leniently as the std::stoi() used by edits, so anything an edit accepts lands on the same key
+			char* parseEnd = nullptr;
+			const long indexOfValue = std::strtol(key.c_str(), &parseEnd, 10);
+			if (parseEnd == key.c_str() || indexOfValue < 0) {
+				break;
+			}
+			key = std::to_string(indexOfValue);
+			jsonValue = ((size_t)indexOfValue < jsonValue->Size()) ? &(*jsonValue)[(rapidjson::SizeType)indexOfValue] : nullptr;
+		}
+		return canonicalPath;
+	}
+	static std::string JoinPath(const std::vector<std::string>& path) {
+		std::string joinedPath = "";
+		for (const std::string& key : path) {
+			if (!joinedPath.empty()) {
+				joinedPath += ".";
+			}
+			joinedPath += key;
+		}
+		return joinedPath;
+	}
+
+	// Holds documentMutex for a change to the document, then sends the change notifications queued under it once it has been released.
+	// Callbacks run unlocked so they are free to read, or change, the document themselves
+	class DocumentLock {
+	public:
+		DocumentLock(JsonFile& jsonFile) : jsonFile(jsonFile) {
+			jsonFile.documentMutex.lock();
+		}
+		~DocumentLock() {
+			std::vector<PendingNotification> notifications;
+			notifications.swap(jsonFile.pendingNotifications);
+			jsonFile.documentMutex.unlock();
+			for (const PendingNotification& notification : notifications) {
+				notification.callback(notification.changedPath, notification.version);
+			}
+		}
+		DocumentLock(const DocumentLock&) = delete;
+		DocumentLock& operator=(const DocumentLock&) = delete;
+
+	private:
+		JsonFile& jsonFile;
+	};
+
+	// Write-behind saving state, only allocated while write-behind mode is enabled
+	struct WriteBehindState {
+		std::thread writerThread;
+		std::mutex stateMutex;
+		std::condition_variable wakeWriter;
+		std::condition_variable writeFinished;	// Signalled each time isWriting goes back to false
+		std::chrono::milliseconds debounceTime = std::chrono::milliseconds(0);
+		std::chrono::steady_clock::time_point lastChangeTime;
+		std::vector<std::promise<bool>> pendingSaves;	// Fulfilled by the next write
+		bool isDirty = false;
+		bool isWriting = false;		// Set from taking the snapshot until it is in the file, isDirty is cleared before the write starts
+		bool wasLastWriteSuccessful = true;
+		bool isStopRequested = false;
+	};
+	std::unique_ptr<WriteBehindState> writeBehind;
+	std::mutex documentMutex;	// Held while the document is changed or snapshotted by the writer thread
+	std::mutex fileMutex;		// Held while the file is being written
+
+	// Called by every function that changes the document, saves straight away unless write-behind mode is enabled
+	bool CommitChanges(void) {
+		if (writeBehind == nullptr) {
+			return Save();
+		}
+		std::lock_guard<std::mutex> stateLock(writeBehind->stateMutex);
+		writeBehind->isDirty = true;
+		writeBehind->lastChangeTime = std::chrono::steady_clock::now();
+		writeBehind->wakeWriter.notify_one();
+		return true;
+	}
+
+	// Body of the writer thread, waits for the document to settle for the debounce time then writes a snapshot of it
+	void WriteBehindLoop(void) {
+		std::unique_lock<std::mutex> stateLock(writeBehind->stateMutex);
+		while (true) {
+			writeBehind->wakeWriter.wait(stateLock, [this]() {
+				return writeBehind->isDirty || !writeBehind->pendingSaves.empty() || writeBehind->isStopRequested;
+			});
+			if (!writeBehind->isDirty && writeBehind->pendingSaves.empty()) {
+				// Stop was requested and there is nothing left to flush
+				return;
+			}
+			// Keep pushing the write back while changes are still arriving, explicit saves and shutdown skip the wait
+			while (writeBehind->isDirty && writeBehind->pendingSaves.empty() && !writeBehind->isStopRequested) {
+				const std::chrono::steady_clock::time_point writeTime = writeBehind->lastChangeTime + writeBehind->debounceTime;
+				if (std::chrono::steady_clock::now() >= writeTime) {
+					break;
+				}
+				writeBehind->wakeWriter.wait_until(stateLock, writeTime);
+			}
+			std::vector<std::promise<bool>> completedSaves;
+			completedSaves.swap(writeBehind->pendingSaves);
+			writeBehind->isDirty = false;
+			writeBehind->isWriting = true;
+
+			stateLock.unlock();
+			const bool wasWritten = WriteSnapshot();
+			for (std::promise<bool>& completedSave : completedSaves) {
+				completedSave.set_value(wasWritten);
+			}
+			stateLock.lock();
+			writeBehind->isWriting = false;
+			writeBehind->wasLastWriteSuccessful = wasWritten;
+			writeBehind->writeFinished.notify_all();
+		}
+	}
+
+	// Serialises the document while holding the document lock, then writes it out without blocking further changes.
+	// Out-of-core documents are written straight to the file under the document lock instead, a snapshot of one would put the whole file on the heap
+	bool WriteSnapshot(void) {
+		JSON_TRACE_SCOPE("WriteSnapshot", fileName, "");
+		rapidjson::StringBuffer snapshotBuffer;
+		std::string snapshotFileName = "";
+		{
+			std::lock_guard<std::mutex> documentLock(documentMutex);
+			if (!isFileLoaded) {
+				std::cout << "JsonFile.hpp >>>> File is not loaded, cannot call Save()" << std::endl;
+				return false;
+			}
+			if (isArchiveEntry) {
+				std::cout << "JsonFile.hpp >>>> Entry: " << fileName << " was loaded from an archive, cannot call Save()" << std::endl;
+				return false;
+			}
+			if (IsOutOfCoreDocument()) {
+				std::lock_guard<std::mutex> fileLock(fileMutex);
+				std::ofstream outFileStream(fileName);
+				if (!outFileStream.is_open()) {
+					std::cout << "JsonFile.hpp >>>> File: " << fileName << " could not be opened for writing" << std::endl;
+					return false;
+				}
+				WriteWithinBudget(outFileStream);
+				JSON_TRACE_BYTES(outFileStream.tellp());
+				return outFileStream.good();
+			}
+			rapidjson::PrettyWriter<rapidjson::StringBuffer> snapshotWriter(snapshotBuffer);
+			jsonDocument->Accept(snapshotWriter);
+			snapshotFileName = fileName;
+		}
+		std::lock_guard<std::mutex> fileLock(fileMutex);
+		std::ofstream outFileStream(snapshotFileName);
+		if (!outFileStream.is_open()) {
+			std::cout << "JsonFile.hpp >>>> File: " << snapshotFileName << " could not be opened for writing" << std::endl;
+			return false;
+		}
+		outFileStream.write(snapshotBuffer.GetString(), snapshotBuffer.GetSize());
+		JSON_TRACE_BYTES(snapshotBuffer.GetSize());
+		return outFileStream.good();
+	}
+
+	// Splits a string using the given splitToken, E.g. ""The.Cat.Sat.On.The.Mat" splits with token '.' into Vector[6] = {The, Cat, Sat, On, The, Mat};
+	std::vector<std::string> JsonFile::SplitString(const std::string& stringToSplit, const char& splitToken) {
+		JSON_TRACE_SCOPE("SplitString", fileName, stringToSplit);
+		JSON_TRACE_BYTES(stringToSplit.size());
+
+		std::vector<std::string> splitString;	// Stores the split sections of string for the return.
+		std::string currentSplit = "";			// Stores the current section being split off.
+
+		size_t sizeOfStringArray = stringToSplit.size();			// .Size() of a const so it never changes and we store it once.
+		for (size_t i = 0; i < sizeOfStringArray; i++) {
+			char currentChar = stringToSplit.at(i);
+			if (currentChar == splitToken) {
+				splitString.push_back(currentSplit);
+				currentSplit = "";
+			}
+			else {
+				currentSplit += currentChar;
+			}
+
+			if (i == sizeOfStringArray - 1 && currentChar != splitToken) {
+				// Catches the final section of string as there might not be a follow up split token.
+				splitString.push_back(currentSplit);
+			}
+		}
+
+		return splitString;
+	}
+	
+	// Walks the DOM along objectName, e.g. root.head.value, returning nullptr and reporting why if the path can't be followed
+	rapidjson::Value* TraverseToValue(const std::string& objectName) {
+		JSON_TRACE_SCOPE("Traverse", fileName, objectName);
+		std::vector<std::string> splitString = SplitString(objectName, '.');
+		rapidjson::Value* jsonValue = jsonDocument;
+		const size_t sizeOfSplitString = splitString.size();
+		for (size_t i = 0; i < sizeOfSplitString; i++) {
+			if (!jsonValue->IsArray()) {
+				if (IsPackedString(*jsonValue)) {
+					std::cout << "JsonFile.hpp >>>> " << objectName << " passes through a packed array, read its elements with GetVector<T>()" << std::endl;
+					return nullptr;
+				}
+				// Only objects have keys, a value can't be traversed any deeper
+				if (!jsonValue->IsObject() || !jsonValue->HasMember(splitString[i].c_str())) {
+					std::cout << "JsonFile.hpp >>>> Could not find key: " << splitString[i] << std::endl;
+					return nullptr;
+				}
+				jsonValue = &(*jsonValue)[splitString[i].c_str()];
+			}
+			else {
+				// Point to the object/key/array at the indicated index in the array
+				int arraySize = jsonValue->Size();
+				int indexOfValue = 0;
+				// try and convert the substring to an int, if not return default
+				try {
+					indexOfValue = std::stoi(splitString[i]);	// convert from our substring to our indexer
+				}
+				catch (...) {
+					std::cout << "JsonFile.hpp >>>> " << objectName << " " << splitString[i] << " is invalid as an index value" << std::endl;
+					return nullptr;
+				}
+				// Check the value is accessible in the bounds of the array
+				if (arraySize > 0) {
+					if (indexOfValue >= 0 && arraySize > indexOfValue) {
+						jsonValue = &(*jsonValue)[indexOfValue];
+					}
+					else {
+						std::cout << "JsonFile.hpp >>>> " << objectName << " index: " << indexOfValue << " is out of bounds" << std::endl;
+						return nullptr;
+					}
+				}
+				else {
+					std::cout << "JsonFile.hpp >>>> " << objectName << " Array is empty" << std::endl;
+					return nullptr;
+				}
+			}
+		}
+		return jsonValue;
+	}
+
+	// Node of the prefix trie built by GetMany(), children are keyed by the next path segment
+	struct BatchTrieNode {
+		std::map<std::string, size_t> children;
+		std::vector<size_t> entries;
+	};
+
+	// Resolves a trie node against the DOM, jsonValue is nullptr if the node's path doesn't exist
+	void ResolveBatchNode(const std::vector<BatchTrieNode>& trie, const size_t& nodeIndex, const rapidjson::Value* jsonValue, std::vector<BatchEntry>& entries, size_t& foundCount) {
+		const BatchTrieNode& node = trie[nodeIndex];
+		for (const size_t& entryIndex : node.entries) {
+			BatchEntry& entry = entries[entryIndex];
+			if (jsonValue == nullptr) {
+				entry.status = BatchStatus::NotFound;
+			}
+			else if (jsonValue->IsObject()) {
+				entry.status = BatchStatus::IsObject;
+			}
+			else if (ReadValueInto(*jsonValue, entry.kind, entry.output)) {
+				entry.status = BatchStatus::Found;
+				foundCount++;
+			}
+			else {
+				entry.status = BatchStatus::TypeMismatch;
+			}
+		}
+		for (const auto& child : node.children) {
+			const rapidjson::Value* childValue = nullptr;
+			if (jsonValue != nullptr) {
+				childValue = FindChildValue(*jsonValue, child.first);
+			}
+			ResolveBatchNode(trie, child.second, childValue, entries, foundCount);
+		}
+	}
+
+	// Maps an output slot's type to its ValueKind, unsupported types fail to compile
+	static inline ValueKind KindOf(const int*) {
+		return ValueKind::Int;
+	}
+	static inline ValueKind KindOf(const float*) {
+		return ValueKind::Float;
+	}
+	static inline ValueKind KindOf(const double*) {
+		return ValueKind::Double;
+	}
+	static inline ValueKind KindOf(const std::string*) {
+		return ValueKind::String;
+	}
+	static inline ValueKind KindOf(const JsonStringView*) {
+		return ValueKind::StringView;
+	}
+	static inline ValueKind KindOf(const bool*) {
+		return ValueKind::Bool;
+	}
+
+	// Type-erased version of GetValue<T>() which writes to output and returns false instead of reporting a type mismatch
+	bool ReadValueInto(const rapidjson::Value& jsonValue, const ValueKind& kind, void* output) {
+		switch (kind) {
+		case ValueKind::Int:
+			if (!jsonValue.IsInt()) {
+				return false;
+			}
+			*static_cast<int*>(output) = jsonValue.GetInt();
+			return true;
+		case ValueKind::Float:
+			if (!jsonValue.IsFloat()) {
+				return false;
+			}
+			*static_cast<float*>(output) = jsonValue.GetFloat();
+			return true;
+		case ValueKind::Double:
+			if (!jsonValue.IsDouble()) {
+				return false;
+			}
+			*static_cast<double*>(output) = jsonValue.GetDouble();
+			return true;
+		case ValueKind::String:
+			if (!jsonValue.IsString()) {
+				return false;
+			}
+			static_cast<std::string*>(output)->assign(jsonValue.GetString(), jsonValue.GetStringLength());
+			return true;
+		case ValueKind::StringView:
+			if (!jsonValue.IsString()) {
+				return false;
+			}
+			*static_cast<JsonStringView*>(output) = JsonStringView(jsonValue.GetString(), jsonValue.GetStringLength());
+			return true;
+		case ValueKind::Bool:
+			if (!jsonValue.IsBool()) {
+				return false;
+			}
+			*static_cast<bool*>(output) = jsonValue.GetBool();
+			return true;
+		}
+		return false;
+	}
+
+	// Type-erased helpers for ExtractColumns(), column points at the std::vector matching kind
+	void ResizeColumn(const ValueKind& kind, void* column, const size_t& numberOfRows) {
+		switch (kind) {
+		case ValueKind::Int:
+			static_cast<std::vector<int>*>(column)->assign(numberOfRows, 0);
+			break;
+		case ValueKind::Float:
+			static_cast<std::vector<float>*>(column)->assign(numberOfRows, 0.0f);
+			break;
+		case ValueKind::Double:
+			static_cast<std::vector<double>*>(column)->assign(numberOfRows, 0.0);
+			break;
+		case ValueKind::String:
+			static_cast<std::vector<std::string>*>(column)->assign(numberOfRows, std::string());
+			break;
+		case ValueKind::StringView:
+			static_cast<std::vector<JsonStringView>*>(column)->assign(numberOfRows, JsonStringView());
+			break;
+		case ValueKind::Bool:
+			static_cast<std::vector<bool>*>(column)->assign(numberOfRows, false);
+			break;
+		}
+	}
+	bool WriteColumnCell(const rapidjson::Value& jsonValue, const ValueKind& kind, void* column, const size_t& row) {
+		switch (kind) {
+		case ValueKind::Int:
+			return ReadValueInto(jsonValue, kind, &(*static_cast<std::vector<int>*>(column))[row]);
+		case ValueKind::Float:
+			return ReadValueInto(jsonValue, kind, &(*static_cast<std::vector<float>*>(column))[row]);
+		case ValueKind::Double:
+			return ReadValueInto(jsonValue, kind, &(*static_cast<std::vector<double>*>(column))[row]);
+		case ValueKind::String:
+			return ReadValueInto(jsonValue, kind, &(*static_cast<std::vector<std::string>*>(column))[row]);
+		case ValueKind::StringView:
+			return ReadValueInto(jsonValue, kind, &(*static_cast<std::vector<JsonStringView>*>(column))[row]);
+		case ValueKind::Bool: {
+			// std::vector<bool> is packed so it can't hand out a pointer to its element
+			bool cell = false;
+			if (!ReadValueInto(jsonValue, kind, &cell)) {
+				return false;
+			}
+			(*static_cast<std::vector<bool>*>(column))[row] = cell;
+			return true;
+		}
+		}
+		return false;
+	}
+
+	// A single parsed segment of a Query<T>() path
+	struct QuerySegment {
+		enum SegmentType { Key, Wildcard, Range, Filter };
+		SegmentType type = Key;
+		std::string key = "";
+		size_t rangeStart = 0;
+		size_t rangeEnd = 0;
+		bool hasRangeEnd = false;
+		std::vector<std::string> filterPath;
+		std::string filterOperator = "";
+		std::string filterLiteral = "";
+	};
+
+	// Splits a query on '.', ignoring any dots inside a [filter] so the filter's relative path stays in one segment
+	bool ParseQuery(const std::string& queryPath, std::vector<QuerySegment>& querySegments) {
+		std::vector<std::string> rawSegments;
+		std::string currentSegment = "";
+		int bracketDepth = 0;
+		for (const char& currentChar : queryPath) {
+			if (currentChar == '[') {
+				bracketDepth++;
+			}
+			else if (currentChar == ']') {
+				bracketDepth--;
+			}
+			if (currentChar == '.' && bracketDepth == 0) {
+				rawSegments.push_back(currentSegment);
+				currentSegment = "";
+			}
+			else {
+				currentSegment += currentChar;
+			}
+		}
+		rawSegments.push_back(currentSegment);
+		if (bracketDepth != 0) {
+			std::cout << "JsonFile.hpp >>>> Query: " << queryPath << " has unbalanced brackets" << std::endl;
+			return false;
+		}
+
+		for (const std::string& rawSegment : rawSegments) {
+			QuerySegment segment;
+			if (rawSegment == "*") {
+				segment.type = QuerySegment::Wildcard;
+			}
+			else if (rawSegment.size() >= 2 && rawSegment.front() == '[' && rawSegment.back() == ']') {
+				// Filter, split the body at the first comparison operator
+				segment.type = QuerySegment::Filter;
+				const std::string filterBody = rawSegment.substr(1, rawSegment.size() - 2);
+				const size_t operatorPosition = filterBody.find_first_of("=!<>");
+				if (operatorPosition == std::string::npos || operatorPosition == 0) {
+					std::cout << "JsonFile.hpp >>>> Query filter: " << rawSegment << " has no comparison operator" << std::endl;
+					return false;
+				}
+				// Take the whole run of operator characters so typos such as == or => are reported rather than read as = and a literal
+				const size_t operatorEnd = filterBody.find_first_not_of("=!<>", operatorPosition);
+				const size_t operatorLength = ((operatorEnd == std::string::npos) ? filterBody.size() : operatorEnd) - operatorPosition;
+				segment.filterOperator = filterBody.substr(operatorPosition, operatorLength);
+				if (segment.filterOperator != "=" && segment.filterOperator != "!=" && segment.filterOperator != "<" && segment.filterOperator != "<=" && segment.filterOperator != ">" && segment.filterOperator != ">=") {
+					std::cout << "JsonFile.hpp >>>> Query filter: " << rawSegment << " has an invalid comparison operator" << std::endl;
+					return false;
+				}
+				segment.filterPath = SplitString(filterBody.substr(0, operatorPosition), '.');
+				segment.filterLiteral = filterBody.substr(operatorPosition + operatorLength);
+				// Allow string literals to be quoted
+				if (segment.filterLiteral.size() >= 2 && segment.filterLiteral.front() == '"' && segment.filterLiteral.back() == '"') {
+					segment.filterLiteral = segment.filterLiteral.substr(1, segment.filterLiteral.size() - 2);
+				}
+			}
+			else if (IsRangeSegment(rawSegment)) {
+				// Range of array elements, start:end
+				segment.type = QuerySegment::Range;
+				const size_t colonPosition = rawSegment.find(':');
+				const std::string startString = rawSegment.substr(0, colonPosition);
+				const std::string endString = rawSegment.substr(colonPosition + 1);
+				try {
+					segment.rangeStart = (startString != "") ? std::stoul(startString) : 0;
+					segment.hasRangeEnd = (endString != "");
+					segment.rangeEnd = segment.hasRangeEnd ? std::stoul(endString) : 0;
+				}
+				catch (...) {
+					std::cout << "JsonFile.hpp >>>> Query range: " << rawSegment << " is invalid" << std::endl;
+					return false;
+				}
+			}
+			else {
+				segment.type = QuerySegment::Key;
+				segment.key = rawSegment;
+			}
+			querySegments.push_back(segment);
+		}
+		return true;
+	}
+
+	// Only digits?:digits? is a range, any other segment containing a ':' is an ordinary key
+	static bool IsRangeSegment(const std::string& rawSegment) {
+		const size_t colonPosition = rawSegment.find(':');
+		if (colonPosition == std::string::npos) {
+			return false;
+		}
+		for (size_t i = 0; i < rawSegment.size(); i++) {
+			if (i != colonPosition && !std::isdigit((unsigned char)rawSegment[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Depth first walk of the DOM, every node reached once all segments are consumed is a match
+	void CollectQueryMatches(const rapidjson::Value& jsonValue, const std::vector<QuerySegment>& querySegments, const size_t& depth, std::vector<const rapidjson::Value*>& matches) {
+		if (depth == querySegments.size()) {
+			matches.push_back(&jsonValue);
+			return;
+		}
+		const QuerySegment& segment = querySegments[depth];
+		switch (segment.type) {
+		case QuerySegment::Key:
+			{
+				const rapidjson::Value* childValue = FindChildValue(jsonValue, segment.key);
+				if (childValue != nullptr) {
+					CollectQueryMatches(*childValue, querySegments, depth + 1, matches);
+				}
+			}
+			break;
+		case QuerySegment::Wildcard:
+		case QuerySegment::Filter:
+			if (jsonValue.IsArray()) {
+				for (const auto& item : jsonValue.GetArray()) {
+					if (segment.type == QuerySegment::Wildcard || MatchesQueryFilter(item, segment)) {
+						CollectQueryMatches(item, querySegments, depth + 1, matches);
+					}
+				}
+			}
+			else if (jsonValue.IsObject()) {
+				for (const auto& member : jsonValue.GetObject()) {
+					if (segment.type == QuerySegment::Wildcard || MatchesQueryFilter(member.value, segment)) {
+						CollectQueryMatches(member.value, querySegments, depth + 1, matches);
+					}
+				}
+			}
+			break;
+		case QuerySegment::Range:
+			if (jsonValue.IsArray()) {
+				const size_t arraySize = jsonValue.Size();
+				const size_t rangeEnd = (segment.hasRangeEnd && segment.rangeEnd < arraySize) ? segment.rangeEnd : arraySize;
+				for (size_t i = segment.rangeStart; i < rangeEnd; i++) {
+					CollectQueryMatches(jsonValue[(rapidjson::SizeType)i], querySegments, depth + 1, matches);
+				}
+			}
+			break;
+		}
+	}
+
+	// Follows a relative path of keys/indexes from jsonValue without reporting failures, used where missing keys are expected
+	const rapidjson::Value* FindRelativeValue(const rapidjson::Value& jsonValue, const std::vector<std::string>& relativePath) {
+		const rapidjson::Value* currentValue = &jsonValue;
+		for (const std::string& key : relativePath) {
+			currentValue = FindChildValue(*currentValue, key);
+			if (currentValue == nullptr) {
+				return nullptr;
+			}
+		}
+		return currentValue;
+	}
+	// Single step of FindRelativeValue(), key is a member name for objects and an index for arrays
+	const rapidjson::Value* FindChildValue(const rapidjson::Value& jsonValue, const std::string& key) {
+		if (jsonValue.IsObject()) {
+			rapidjson::Value::ConstMemberIterator member = jsonValue.FindMember(key.c_str());
+			if (member == jsonValue.MemberEnd()) {
+				return nullptr;
+			}
+			return &member->value;
+		}
+		else if (jsonValue.IsArray()) {
+			char* parseEnd = nullptr;
+			const unsigned long indexOfValue = std::strtoul(key.c_str(), &parseEnd, 10);
+			if (key == "" || *parseEnd != '\0' || indexOfValue >= jsonValue.Size()) {
+				return nullptr;
+			}
+			return &jsonValue[(rapidjson::SizeType)indexOfValue];
+		}
+		return nullptr;
+	}
+
+	// Compares the value at the filter's relative path against its literal, numbers compare numerically and strings lexicographically
+	bool MatchesQueryFilter(const rapidjson::Value& jsonValue, const QuerySegment& segment) {
+		const rapidjson::Value* filterValue = FindRelativeValue(jsonValue, segment.filterPath);
+		if (filterValue == nullptr) {
+			return false;
+		}
+		int comparison = 0;
+		if (filterValue->IsNumber()) {
+			char* parseEnd = nullptr;
+			const double literalValue = std::strtod(segment.filterLiteral.c_str(), &parseEnd);
+			if (segment.filterLiteral == "" || *parseEnd != '\0') {
+				return false;
+			}
+			const double nodeValue = filterValue->GetDouble();
+			comparison = (nodeValue < literalValue) ? -1 : ((nodeValue > literalValue) ? 1 : 0);
+		}
+		else if (filterValue->IsString()) {
+			comparison = segment.filterLiteral.compare(0, std::string::npos, filterValue->GetString(), filterValue->GetStringLength());
+			comparison = (comparison < 0) ? 1 : ((comparison > 0) ? -1 : 0);	// compare() was literal against node, flip it to node against literal
+		}
+		else if (filterValue->IsBool()) {
+			if (segment.filterLiteral != "true" && segment.filterLiteral != "false") {
+				return false;
+			}
+			comparison = (filterValue->GetBool() == (segment.filterLiteral == "true")) ? 0 : 1;
+			if (segment.filterOperator != "=" && segment.filterOperator != "!=") {
+				return false;
+			}
+		}
+		else if (filterValue->IsNull()) {
+			comparison = (segment.filterLiteral == "null") ? 0 : 1;
+			if (segment.filterOperator != "=" && segment.filterOperator != "!=") {
+				return false;
+			}
+		}
+		else {
+			return false;
+		}
+
+		if (segment.filterOperator == "=") {
+			return comparison == 0;
+		}
+		else if (segment.filterOperator == "!=") {
+			return comparison != 0;
+		}
+		else if (segment.filterOperator == "<") {
+			return comparison < 0;
+		}
+		else if (segment.filterOperator == "<=") {
+			return comparison <= 0;
+		}
+		else if (segment.filterOperator == ">") {
+			return comparison > 0;
+		}
+		else if (segment.filterOperator == ">=") {
+			return comparison >= 0;
+		}
+		return false;
+	}
+
+	// Packed array helpers
+	static const char* PackedPrefix(void) {
+		return "@packed:";
+	}
+	static const char* PackedTypeName(const PackedType& packedType) {
+		switch (packedType) {
+		case PackedType::Int8:
+			return "i8";
+		case PackedType::Int16:
+			return "i16";
+		case PackedType::Int32:
+			return "i32";
+		case PackedType::Float32:
+			return "f32";
+		case PackedType::Float64:
+			return "f64";
+		}
+		return "";
+	}
+	static size_t PackedTypeSize(const PackedType& packedType) {
+		switch (packedType) {
+		case PackedType::Int8:
+			return 1;
+		case PackedType::Int16:
+			return 2;
+		case PackedType::Int32:
+		case PackedType::Float32:
+			return 4;
+		case PackedType::Float64:
+			return 8;
+		}
+		return 1;
+	}
+	// Splits a packed string into its element type and base64 payload, returns false if jsonValue isn't a packed array or they're disabled
+	bool ParsePackedString(const rapidjson::Value& jsonValue, PackedType& packedType, const char*& payload, size_t& payloadSize) {
+		if (!usePackedArrays || !jsonValue.IsString()) {
+			return false;
+		}
+		const char* packedString = jsonValue.GetString();
+		const size_t packedLength = jsonValue.GetStringLength();
+		const size_t prefixLength = std::strlen(PackedPrefix());
+		if (packedLength < prefixLength || std::strncmp(packedString, PackedPrefix(), prefixLength) != 0) {
+			return false;
+		}
+		const PackedType packedTypes[] = { PackedType::Int8, PackedType::Int16, PackedType::Int32, PackedType::Float32, PackedType::Float64 };
+		for (const PackedType& candidateType : packedTypes) {
+			const char* typeName = PackedTypeName(candidateType);
+			const size_t typeLength = std::strlen(typeName);
+			if (packedLength > prefixLength + typeLength && std::strncmp(packedString + prefixLength, typeName, typeLength) == 0 && packedString[prefixLength + typeLength] == ':') {
+				packedType = candidateType;
+				payload = packedString + prefixLength + typeLength + 1;
+				payloadSize = packedLength - (prefixLength + typeLength + 1);
+				return true;
+			}
+		}
+		return false;
+	}
+	bool IsPackedString(const rapidjson::Value& jsonValue) {
+		PackedType packedType;
+		const char* payload = nullptr;
+		size_t payloadSize = 0;
+		return ParsePackedString(jsonValue, packedType, payload, payloadSize);
+	}
+	PackedType GetPackedType(const rapidjson::Value& jsonValue) {
+		PackedType packedType = PackedType::Int32;
+		const char* payload = nullptr;
+		size_t payloadSize = 0;
+		ParsePackedString(jsonValue, packedType, payload, payloadSize);
+		return packedType;
+	}
+	size_t PackedArraySize(const rapidjson::Value& jsonValue) {
+		PackedType packedType = PackedType::Int32;
+		const char* payload = nullptr;
+		size_t payloadSize = 0;
+		if (!ParsePackedString(jsonValue, packedType, payload, payloadSize) || payloadSize < 4) {
+			return 0;
+		}
+		const size_t padding = (payload[payloadSize - 1] == '=') ? ((payload[payloadSize - 2] == '=') ? 2 : 1) : 0;
+		return (payloadSize / 4 * 3 - padding) / PackedTypeSize(packedType);
+	}
+
+	// Decodes a packed array into result, only numeric element types can be read and integers can't be read as floats or vice versa
+	template<typename T> inline bool DecodePackedArray(const rapidjson::Value& jsonValue, std::vector<T>& result) {
+		std::cout << "JsonFile.hpp >>>> packed arrays can only be read as int, float or double" << std::endl;
+		return false;
+	}
+	template<> inline bool DecodePackedArray(const rapidjson::Value& jsonValue, std::vector<int>& result) {
+		return DecodePackedElements<int>(jsonValue, result, false);
+	}
+	template<> inline bool DecodePackedArray(const rapidjson::Value& jsonValue, std::vector<float>& result) {
+		return DecodePackedElements<float>(jsonValue, result, true);
+	}
+	template<> inline bool DecodePackedArray(const rapidjson::Value& jsonValue, std::vector<double>& result) {
+		return DecodePackedElements<double>(jsonValue, result, true);
+	}
+	template<typename T> inline bool DecodePackedElements(const rapidjson::Value& jsonValue, std::vector<T>& result, const bool& isFloatingPoint) {
+		PackedType packedType = PackedType::Int32;
+		const char* payload = nullptr;
+		size_t payloadSize = 0;
+		ParsePackedString(jsonValue, packedType, payload, payloadSize);
+		const bool isPackedFloatingPoint = (packedType == PackedType::Float32 || packedType == PackedType::Float64);
+		if (isFloatingPoint != isPackedFloatingPoint) {
+			std::cout << "JsonFile.hpp >>>> packed array of " << PackedTypeName(packedType) << " can't be read as this type" << std::endl;
+			return false;
+		}
+		std::vector<unsigned char> bytes;
+		if (!JsonBase64::Decode(payload, payloadSize, bytes)) {
+			std::cout << "JsonFile.hpp >>>> packed array has an invalid base64 payload" << std::endl;
+			return false;
+		}
+		const size_t elementSize = PackedTypeSize(packedType);
+		const size_t elementCount = bytes.size() / elementSize;
+		result.resize(elementCount);
+		const unsigned char* element = bytes.data();
+		for (size_t i = 0; i < elementCount; i++, element += elementSize) {
+			uint64_t bits = 0;
+			for (size_t b = 0; b < elementSize; b++) {
+				bits |= (uint64_t)element[b] << (b * 8);
+			}
+			switch (packedType) {
+			case PackedType::Int8:
+				result[i] = (T)(int8_t)bits;
+				break;
+			case PackedType::Int16:
+				result[i] = (T)(int16_t)bits;
+				break;
+			case PackedType::Int32:
+				result[i] = (T)(int32_t)bits;
+				break;
+			case PackedType::Float32: {
+				const uint32_t floatBits = (uint32_t)bits;
+				float floatValue;
+				std::memcpy(&floatValue, &floatBits, sizeof(floatValue));
+				result[i] = (T)floatValue;
+				break;
+			}
+			case PackedType::Float64: {
+				double doubleValue;
+				std::memcpy(&doubleValue, &bits, sizeof(doubleValue));
+				result[i] = (T)doubleValue;
+				break;
+			}
+			}
+		}
+		return true;
+	}
+
+	// Encodes inputValueVector into jsonValue as a packed array, integer types reject values that don't fit
+	template<typename T> inline bool SetPackedValue(rapidjson::Value& jsonValue, const std::vector<T>& inputValueVector, const PackedType& packedType) {
+		std::cout << "JsonFile.hpp >>>> packed arrays can only be written from int, float or double" << std::endl;
+		return false;
+	}
+	template<> inline bool SetPackedValue(rapidjson::Value& jsonValue, const std::vector<int>& inputValueVector, const PackedType& packedType) {
+		return EncodePackedElements<int>(jsonValue, inputValueVector, packedType);
+	}
+	template<> inline bool SetPackedValue(rapidjson::Value& jsonValue, const std::vector<float>& inputValueVector, const PackedType& packedType) {
+		return EncodePackedElements<float>(jsonValue, inputValueVector, packedType);
+	}
+	template<> inline bool SetPackedValue(rapidjson::Value& jsonValue, const std::vector<double>& inputValueVector, const PackedType& packedType) {
+		return EncodePackedElements<double>(jsonValue, inputValueVector, packedType);
+	}
+	template<typename T> inline bool EncodePackedElements(rapidjson::Value& jsonValue, const std::vector<T>& inputValueVector, const PackedType& packedType) {
+		const size_t elementSize = PackedTypeSize(packedType);
+		std::vector<unsigned char> bytes(inputValueVector.size() * elementSize);
+		unsigned char* element = bytes.data();
+		for (const T& item : inputValueVector) {
+			uint64_t bits = 0;
+			const double itemValue = (double)item;
+			switch (packedType) {
+			case PackedType::Int8:
+			case PackedType::Int16:
+			case PackedType::Int32: {
+				const double maxValue = (double)((1LL << (elementSize * 8 - 1)) - 1);
+				// Range check first, it also rejects NaN, so the cast below is always defined
+				if (!(itemValue >= -maxValue - 1 && itemValue <= maxValue) || itemValue != (double)(long long)itemValue) {
+					std::cout << "JsonFile.hpp >>>> value " << itemValue << " doesn't fit in a packed " << PackedTypeName(packedType) << std::endl;
+					return false;
+				}
+				bits = (uint64_t)(long long)itemValue;
+				break;
+			}
+			case PackedType::Float32: {
+				const float floatValue = (float)item;
+				uint32_t floatBits;
+				std::memcpy(&floatBits, &floatValue, sizeof(floatBits));
+				bits = floatBits;
+				break;
+			}
+			case PackedType::Float64:
+				std::memcpy(&bits, &itemValue, sizeof(bits));
+				break;
+			}
+			for (size_t b = 0; b < elementSize; b++) {
+				element[b] = (unsigned char)(bits >> (b * 8));
+			}
+			element += elementSize;
+		}
+		std::string packedString = std::string(PackedPrefix()) + PackedTypeName(packedType) + ":";
+		JsonBase64::Encode(bytes.data(), bytes.size(), packedString);
+		jsonValue.SetString(packedString.c_str(), (rapidjson::SizeType)packedString.length(), jsonDocument->GetAllocator());
+		return true;
+	}
+
+	// Get Default value Functions, uses Templating
+	template<typename T> inline T GetDefaultValue() {
+		return 0;
+	}
+	template<> inline std::string GetDefaultValue() {
+		return "";
+	}
+	template<> inline JsonStringView GetDefaultValue() {
+		return JsonStringView();
+	}
+	
+	// Get value functions, uses Templating overrides
+	template<typename T> inline T GetValue(const rapidjson::Value& jsonValue) {
+		return GetDefaultValue<T>();
+	}
+	template<> inline int GetValue(const rapidjson::Value& jsonValue) {
+		if (jsonValue.IsInt()) {
+			return jsonValue.GetInt();
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> value is not an Int" << std::endl;
+			return GetDefaultValue<int>();
+		}
+	}
+	template<> inline float GetValue(const rapidjson::Value& jsonValue) {
+		if (jsonValue.IsFloat()) {
+			return jsonValue.GetFloat();
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> value is not a float" << std::endl;
+			return GetDefaultValue<float>();
+		}
+	}
+	template<> inline double GetValue(const rapidjson::Value& jsonValue) {
+		if (jsonValue.IsDouble()) {
+			return jsonValue.GetDouble();
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> value is not a double" << std::endl;
+			return GetDefaultValue<double>();
+		}
+	}
+	template<> inline std::string GetValue(const rapidjson::Value& jsonValue) {
+		if (jsonValue.IsString()) {
+			return jsonValue.GetString();
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> value is not a std::string" << std::endl;
+			return GetDefaultValue<std::string>();
+		}
+	}
+	template<> inline JsonStringView GetValue(const rapidjson::Value& jsonValue) {
+		if (jsonValue.IsString()) {
+			return JsonStringView(jsonValue.GetString(), jsonValue.GetStringLength());
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> value is not a std::string" << std::endl;
+			return GetDefaultValue<JsonStringView>();
+		}
+	}
+	template<> inline bool GetValue(const rapidjson::Value& jsonValue) {
+		if (jsonValue.IsBool()) {
+			return jsonValue.GetBool();
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> value is not a boolean" << std::endl;
+			return GetDefaultValue<bool>();
+		}
+	}
+	
+	// Set value functions, uses Templating overrides to check typing per data type
+	template<typename T> inline bool SetValue(rapidjson::Value& jsonValue, const T& inputValue) {
+		return false;
+	}
+	template<> inline bool SetValue(rapidjson::Value& jsonValue, const int& inputValue) {
+		if (jsonValue.IsInt()) {
+			jsonValue.SetInt(inputValue);
+			return true;
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> value is not an Int" << std::endl;
+			return false;
+		}
+	}
+	template<> inline bool SetValue(rapidjson::Value& jsonValue, const float& inputValue) {
+		if (jsonValue.IsFloat()) {
+			jsonValue.SetFloat(inputValue);
+			return true;
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> value is not a Float" << std::endl;
+			return false;
+		}
+	}
+	template<> inline bool SetValue(rapidjson::Value& jsonValue, const double& inputValue) {
+		if (jsonValue.IsDouble()) {
+			jsonValue.SetDouble(inputValue);
+			return true;
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> value is not a Double" << std::endl;
+			return false;
+		}
+	}
+	template<> inline bool SetValue(rapidjson::Value& jsonValue, const std::string& inputValue) {
+		if (jsonValue.IsString()) {
+			jsonValue.SetString(inputValue.c_str(), (rapidjson::SizeType)inputValue.length(), jsonDocument->GetAllocator());
+			return true;
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> value is not a String" << std::endl;
+			return false;
+		}
+	}
+	template<> inline bool SetValue(rapidjson::Value& jsonValue, const bool& inputValue) {
+		if (jsonValue.IsBool()) {
+			jsonValue.SetBool(inputValue);
+			return true;
+		}
+		else {
+			std::cout << "JsonFile.hpp >>>> value is not a Boolean" << std::endl;
+			return false;
+		}
+	}
+	
+	// Set Array functions, uses templating to get round issues with std::string
 	template<typename T> inline void SetVectorOfValues(rapidjson::Value& jsonValue, const std::vector<T>& inputValueVector) {
 		// Clear the array
 		jsonValue.SetArray();
@@ -899,62 +3681,58 @@ private:
 		jsonValue.SetArray();
 		// iterate through the passed vector and push each element to the json document
 		for (const std::string& item : inputValueVector) {
-			jsonValue.PushBack(rapidjson::StringRef(item.c_str()), jsonDocument->GetAllocator());
+			rapidjson::Value newString(item.c_str(), (rapidjson::SizeType)item.length(), jsonDocument->GetAllocator());
+			jsonValue.PushBack(newString, jsonDocument->GetAllocator());
 		}
 	}
 	
 	// Insert value functions, uses templting to get round issues with std::string
-	template<typename T> inline void InsertValue(rapidjson::Value& jsonValue, const std::string& keyName, const T& inputValue) {
+	template<typename T> inline bool InsertValue(rapidjson::Value& jsonValue, const std::string& keyName, const T& inputValue) {
 		// Check the json node we are at is an object, otherwise we can't insert a value
 		if (jsonValue.IsObject()) {
 			// Check the key we want to insert doesn't already exist at the current point in the document
 			if (!jsonValue.HasMember(keyName.c_str())) {
 				// Insert the new Key
-				jsonValue.AddMember(rapidjson::StringRef(keyName.c_str()), inputValue, jsonDocument->GetAllocator());
-
-				// Save the changes to the JSON file we have made
-				if (!Save()) {
-					std::cout << "JsonFile.hpp >>>> Failed to save file" << std::endl;
-					return;
-				}
+				rapidjson::Value newKey;
+				SetKeyValue(newKey, keyName);
+				jsonValue.AddMember(newKey, inputValue, jsonDocument->GetAllocator());
+				return true;	// The caller journals the insert and then commits it
 			}
 			else {
 				std::cout << "JsonFile.hpp >>>> Key: " << keyName << " Already exists in the document" << std::endl;
-				return;
+				return false;
 			}
 		}
 		else {
 			std::cout << "JsonFile.hpp >>>> Values can only be inserted into objects, not values" << std::endl;
-			return;
+			return false;
 		}
 	}
-	template<> inline void InsertValue(rapidjson::Value& jsonValue, const std::string& keyName, const std::string& inputValue) {
+	template<> inline bool InsertValue(rapidjson::Value& jsonValue, const std::string& keyName, const std::string& inputValue) {
 		// Check the json node we are at is an object, otherwise we can't insert a value
 		if (jsonValue.IsObject()) {
 			// Check the key we want to insert doesn't already exist at the current point in the document
 			if (!jsonValue.HasMember(keyName.c_str())) {
 				// Insert the new Key
-				jsonValue.AddMember(rapidjson::StringRef(keyName.c_str()), rapidjson::StringRef(inputValue.c_str()), jsonDocument->GetAllocator());
-
-				// Save the changes to the JSON file we have made
-				if (!Save()) {
-					std::cout << "JsonFile.hpp >>>> Failed to save file" << std::endl;
-					return;
-				}
+				rapidjson::Value newKey;
+				SetKeyValue(newKey, keyName);
+				rapidjson::Value newString(inputValue.c_str(), (rapidjson::SizeType)inputValue.length(), jsonDocument->GetAllocator());
+				jsonValue.AddMember(newKey, newString, jsonDocument->GetAllocator());
+				return true;	// The caller journals the insert and then commits it
 			}
 			else {
 				std::cout << "JsonFile.hpp >>>> Key: " << keyName << " Already exists in the document" << std::endl;
-				return;
+				return false;
 			}
 		}
 		else {
 			std::cout << "JsonFile.hpp >>>> Values can only be inserted into objects, not values" << std::endl;
-			return;
+			return false;
 		}
 	}
 	
 	// Insert value array functions, uses templting to get round issues with std::string
-	template<typename T> inline void InsertVectorOfValues(rapidjson::Value& jsonValue, const std::string& keyName, const std::vector<T>& inputValueVector) {
+	template<typename T> inline bool InsertVectorOfValues(rapidjson::Value& jsonValue, const std::string& keyName, const std::vector<T>& inputValueVector) {
 		// Check the json node we are at is an object, otherwise we can't insert a value
 		if (jsonValue.IsObject()) {
 			// Check the key we want to insert doesn't already exist at the current point in the document
@@ -968,26 +3746,23 @@ private:
 					newArray.PushBack(item, jsonDocument->GetAllocator());
 				}
 
-				jsonValue.AddMember(rapidjson::StringRef(keyName.c_str()), newArray, jsonDocument->GetAllocator());
+				rapidjson::Value newKey;
+				SetKeyValue(newKey, keyName);
+				jsonValue.AddMember(newKey, newArray, jsonDocument->GetAllocator());
 
-
-				// Save the changes to the JSON file we have made
-				if (!Save()) {
-					std::cout << "JsonFile.hpp >>>> Failed to save file" << std::endl;
-					return;
-				}
+				return true;	// The caller journals the insert and then commits it
 			}
 			else {
 				std::cout << "JsonFile.hpp >>>> Key: " << keyName << " Already exists in the document" << std::endl;
-				return;
+				return false;
 			}
 		}
 		else {
 			std::cout << "JsonFile.hpp >>>> Values can only be inserted into objects, not values" << std::endl;
-			return;
+			return false;
 		}
 	}
-	template<> inline void InsertVectorOfValues(rapidjson::Value& jsonValue, const std::string& keyName, const std::vector<std::string>& inputValueVector) {
+	template<> inline bool InsertVectorOfValues(rapidjson::Value& jsonValue, const std::string& keyName, const std::vector<std::string>& inputValueVector) {
 		// Check the json node we are at is an object, otherwise we can't insert a value
 		if (jsonValue.IsObject()) {
 			// Check the key we want to insert doesn't already exist at the current point in the document
@@ -998,26 +3773,24 @@ private:
 				newArray.SetArray();
 				// iterate through the passed vector and push each element to the json document
 				for (const std::string& item : inputValueVector) {
-					newArray.PushBack(rapidjson::StringRef(item.c_str()), jsonDocument->GetAllocator());
+					rapidjson::Value newString(item.c_str(), (rapidjson::SizeType)item.length(), jsonDocument->GetAllocator());
+					newArray.PushBack(newString, jsonDocument->GetAllocator());
 				}
 
-				jsonValue.AddMember(rapidjson::StringRef(keyName.c_str()), newArray, jsonDocument->GetAllocator());
+				rapidjson::Value newKey;
+				SetKeyValue(newKey, keyName);
+				jsonValue.AddMember(newKey, newArray, jsonDocument->GetAllocator());
 
-
-				// Save the changes to the JSON file we have made
-				if (!Save()) {
-					std::cout << "JsonFile.hpp >>>> Failed to save file" << std::endl;
-					return;
-				}
+				return true;	// The caller journals the insert and then commits it
 			}
 			else {
 				std::cout << "JsonFile.hpp >>>> Key: " << keyName << " Already exists in the document" << std::endl;
-				return;
+				return false;
 			}
 		}
 		else {
 			std::cout << "JsonFile.hpp >>>> Values can only be inserted into objects, not values" << std::endl;
-			return;
+			return false;
 		}
 	}
 
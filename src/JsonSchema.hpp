@@ -0,0 +1,200 @@
+#ifndef CPP_JSON_PARSER_JSONSCHEMA_HPP_
+#define CPP_JSON_PARSER_JSONSCHEMA_HPP_
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "rapidjson/document.h"
+#include <rapidjson/istreamwrapper.h>
+#include <rapidjson/reader.h>
+#include <rapidjson/schema.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/error/en.h>
+#include "JsonStringPool.hpp"
+
+// A JSON schema (draft 4) compiled once so any number of loads can be validated against it
+class JsonSchema {
+public:
+	// Constructors & Deconstructors
+	JsonSchema(void) {}
+	JsonSchema(const std::string& schemaFileName) {
+		Load(schemaFileName);
+	}
+	JsonSchema(const JsonSchema&) = delete;
+	JsonSchema& operator=(const JsonSchema&) = delete;
+
+	// Returns the compiled schema for schemaFileName, each file is only read and compiled the first time it is asked for
+	static std::shared_ptr<const JsonSchema> FromFile(const std::string& schemaFileName) {
+		static std::mutex cacheMutex;
+		static std::map<std::string, std::shared_ptr<const JsonSchema>> cachedSchemas;
+		std::lock_guard<std::mutex> cacheLock(cacheMutex);
+		std::map<std::string, std::shared_ptr<const JsonSchema>>::iterator cachedSchema = cachedSchemas.find(schemaFileName);
+		if (cachedSchema != cachedSchemas.end()) {
+			return cachedSchema->second;
+		}
+		std::shared_ptr<const JsonSchema> newSchema = std::make_shared<JsonSchema>(schemaFileName);
+		if (newSchema->IsLoaded()) {
+			// Failed schemas aren't cached so a fixed file can be picked up by trying again
+			cachedSchemas[schemaFileName] = newSchema;
+		}
+		return newSchema;
+	}
+
+	bool Load(const std::string& schemaFileName) {
+		this->schemaFileName = schemaFileName;
+		compiledSchema.reset();
+		std::ifstream fileStream(schemaFileName);
+		rapidjson::IStreamWrapper inputStream(fileStream);
+		schemaSource.ParseStream(inputStream);
+		if (schemaSource.HasParseError()) {
+			std::cout << "JsonSchema.hpp >>>> Schema: " << schemaFileName << " was not loaded" << std::endl;
+			std::cout << "JsonSchema.hpp >>>> Parser Errors: " << rapidjson::GetParseError_En(schemaSource.GetParseError()) << std::endl;
+			return false;
+		}
+		compiledSchema.reset(new rapidjson::SchemaDocument(schemaSource));
+		return true;
+	}
+
+	// Accessors
+	const bool IsLoaded(void) const {
+		return compiledSchema != nullptr;
+	}
+	const std::string& GetSchemaFileName(void) const {
+		return schemaFileName;
+	}
+	const rapidjson::SchemaDocument& GetSchemaDocument(void) const {
+		return *compiledSchema;
+	}
+
+private:
+	std::string schemaFileName = "";
+	rapidjson::Document schemaSource;	// Kept alive alongside the compiled schema which was built from it
+	std::unique_ptr<rapidjson::SchemaDocument> compiledSchema;
+};
+
+// A single schema violation found while loading a document
+struct JsonSchemaViolation {
+	std::string documentPath = "";	// Path to the offending value in the same form Get<T>() takes, e.g. engine.window.title
+	std::string schemaPath = "";	// JSON pointer to the schema rule that failed, e.g. #/properties/engine/required
+	std::string keyword = "";		// The schema keyword that failed, e.g. required, type or minimum
+};
+
+// SAX handler which validates every event against a schema before forwarding it on to outputHandler.
+// rapidjson's validator can't carry on after its first failure, so later events are only forwarded when validation continues past an error
+template<typename OutputHandler> class JsonSchemaHandler {
+public:
+	JsonSchemaHandler(OutputHandler& outputHandler, const JsonSchema& schema, const bool& stopOnFirstError) : outputHandler(outputHandler), validator(schema.GetSchemaDocument()), stopOnFirstError(stopOnFirstError) {}
+
+	bool Null(void) {
+		return Validate(!isValidating || validator.Null()) && outputHandler.Null();
+	}
+	bool Bool(bool value) {
+		return Validate(!isValidating || validator.Bool(value)) && outputHandler.Bool(value);
+	}
+	bool Int(int value) {
+		return Validate(!isValidating || validator.Int(value)) && outputHandler.Int(value);
+	}
+	bool Uint(unsigned value) {
+		return Validate(!isValidating || validator.Uint(value)) && outputHandler.Uint(value);
+	}
+	bool Int64(int64_t value) {
+		return Validate(!isValidating || validator.Int64(value)) && outputHandler.Int64(value);
+	}
+	bool Uint64(uint64_t value) {
+		return Validate(!isValidating || validator.Uint64(value)) && outputHandler.Uint64(value);
+	}
+	bool Double(double value) {
+		return Validate(!isValidating || validator.Double(value)) && outputHandler.Double(value);
+	}
+	bool RawNumber(const char* value, rapidjson::SizeType length, bool copy) {
+		return Validate(!isValidating || validator.RawNumber(value, length, copy)) && outputHandler.RawNumber(value, length, copy);
+	}
+	bool String(const char* value, rapidjson::SizeType length, bool copy) {
+		return Validate(!isValidating || validator.String(value, length, copy)) && outputHandler.String(value, length, copy);
+	}
+	bool StartObject(void) {
+		return Validate(!isValidating || validator.StartObject()) && outputHandler.StartObject();
+	}
+	bool Key(const char* key, rapidjson::SizeType length, bool copy) {
+		return Validate(!isValidating || validator.Key(key, length, copy)) && outputHandler.Key(key, length, copy);
+	}
+	bool EndObject(rapidjson::SizeType memberCount) {
+		return Validate(!isValidating || validator.EndObject(memberCount)) && outputHandler.EndObject(memberCount);
+	}
+	bool StartArray(void) {
+		return Validate(!isValidating || validator.StartArray()) && outputHandler.StartArray();
+	}
+	bool EndArray(rapidjson::SizeType elementCount) {
+		return Validate(!isValidating || validator.EndArray(elementCount)) && outputHandler.EndArray(elementCount);
+	}
+
+	const std::vector<JsonSchemaViolation>& GetViolations(void) const {
+		return violations;
+	}
+
+private:
+	OutputHandler& outputHandler;
+	rapidjson::SchemaValidator validator;
+	bool stopOnFirstError;
+	bool isValidating = true;
+	std::vector<JsonSchemaViolation> violations;
+
+	// Records the validator's failure, returns whether the parse should carry on
+	bool Validate(const bool& isValid) {
+		if (isValid) {
+			return true;
+		}
+		JsonSchemaViolation violation;
+		const rapidjson::Pointer& documentPointer = validator.GetInvalidDocumentPointer();
+		const size_t tokenCount = documentPointer.GetTokenCount();
+		for (size_t i = 0; i < tokenCount; i++) {
+			if (i > 0) {
+				violation.documentPath += ".";
+			}
+			violation.documentPath.append(documentPointer.GetTokens()[i].name, documentPointer.GetTokens()[i].length);
+		}
+		rapidjson::StringBuffer schemaPath;
+		validator.GetInvalidSchemaPointer().StringifyUriFragment(schemaPath);
+		violation.schemaPath = schemaPath.GetString();
+		violation.keyword = validator.GetInvalidSchemaKeyword();
+		violations.push_back(violation);
+		isValidating = false;
+		return !stopOnFirstError;
+	}
+};
+
+// Generator for rapidjson::Document::Populate() which parses and validates inputStream in a single pass, interning through stringPool if one is given
+template<typename InputStream> class JsonSchemaGenerator {
+public:
+	JsonSchemaGenerator(InputStream& inputStream, const JsonSchema& schema, const bool& stopOnFirstError, JsonStringPool* stringPool, const size_t& maxInternedValueLength) : inputStream(inputStream), schema(schema), stopOnFirstError(stopOnFirstError), stringPool(stringPool), maxInternedValueLength(maxInternedValueLength) {}
+
+	template<typename Document> bool operator()(Document& jsonDocument) {
+		JsonSchemaHandler<Document> schemaHandler(jsonDocument, schema, stopOnFirstError);
+		rapidjson::Reader reader;
+		if (stringPool != nullptr) {
+			JsonInterningHandler<JsonSchemaHandler<Document>> interningHandler(schemaHandler, *stringPool, maxInternedValueLength);
+			parseResult = reader.Parse(inputStream, interningHandler);
+		}
+		else {
+			parseResult = reader.Parse(inputStream, schemaHandler);
+		}
+		violations = schemaHandler.GetViolations();
+		return !parseResult.IsError();
+	}
+
+	rapidjson::ParseResult parseResult;
+	std::vector<JsonSchemaViolation> violations;
+
+private:
+	InputStream& inputStream;
+	const JsonSchema& schema;
+	bool stopOnFirstError;
+	JsonStringPool* stringPool;
+	size_t maxInternedValueLength;
+};
+
+#endif
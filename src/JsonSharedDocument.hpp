@@ -0,0 +1,518 @@
+#ifndef CPP_JSON_PARSER_JSONSHAREDDOCUMENT_HPP_
+#define CPP_JSON_PARSER_JSONSHAREDDOCUMENT_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include "rapidjson/document.h"
+#include "SharedMemorySegment.hpp"
+
+// Offset-based flat layout of a document, so it can be mapped at any address in any process.
+// A published document is two segments, a control segment "<name>" holding the current version and a data segment "<name>.v<version>" per version.
+//   Data    | magic "JSONSHM1" | uint64 version | uint64 segment size | uint64 reserved | root FlatNode | nodes, member tables and strings |
+// Every offset is from the start of the data segment and everything is 8 byte aligned
+class JsonSharedLayout {
+public:
+	enum NodeType : uint32_t { Null, False, True, Object, Array, String, Int64, Uint64, Double };
+	// A single value, containers and strings point at their contents by offset
+	struct FlatNode {
+		uint32_t type;
+		uint32_t count;		// Members, elements or string length
+		uint64_t payload;	// Offset of the contents, or the number's bits
+	};
+	// Object members are sorted by key so lookups can binary search them
+	struct FlatMember {
+		uint64_t keyOffset;
+		uint32_t keyLength;
+		uint32_t reserved;
+		FlatNode value;
+	};
+	struct DataHeader {
+		char magic[8];
+		uint64_t version;
+		uint64_t segmentSize;
+		uint64_t reserved;
+		FlatNode root;
+	};
+	struct ControlBlock {
+		char magic[8];
+		std::atomic<uint64_t> version;	// 0 until the first publish
+	};
+	// Readers map the control segment read-only, which is only safe if loading the version is a plain load rather than a locked or compare-exchange one
+	static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "JsonSharedDocument needs lock-free 64 bit atomics");
+
+	static const char* DataMagic(void) {
+		return "JSONSHM1";
+	}
+	static const char* ControlMagic(void) {
+		return "JSONCTL1";
+	}
+	static std::string DataSegmentName(const std::string& segmentName, const uint64_t& version) {
+		return segmentName + ".v" + std::to_string(version);
+	}
+
+	// Writes the flat layout of a document. Run once without a buffer to size it, then again to fill a buffer of that size
+	class Writer {
+	public:
+		Writer(char* outputData) : outputData(outputData), writePosition(sizeof(DataHeader)) {}
+
+		void WriteDocument(const rapidjson::Value& jsonValue, const uint64_t& version) {
+			FlatNode root;
+			WriteValue(jsonValue, root);
+			if (outputData != nullptr) {
+				DataHeader header;
+				std::memcpy(header.magic, DataMagic(), 8);
+				header.version = version;
+				header.segmentSize = writePosition;
+				header.reserved = 0;
+				header.root = root;
+				std::memcpy(outputData, &header, sizeof(header));
+			}
+		}
+		const size_t Size(void) const {
+			return writePosition;
+		}
+
+	private:
+		char* outputData;
+		size_t writePosition;
+
+		size_t Allocate(const size_t& size) {
+			const size_t offset = writePosition;
+			writePosition += (size + 7) / 8 * 8;
+			return offset;
+		}
+		void WriteBytes(const size_t& offset, const void* data, const size_t& size) {
+			if (outputData != nullptr) {
+				std::memcpy(outputData + offset, data, size);
+			}
+		}
+		size_t WriteString(const char* stringData, const size_t& length) {
+			const size_t offset = Allocate(length + 1);
+			WriteBytes(offset, stringData, length);
+			WriteBytes(offset + length, "", 1);
+			return offset;
+		}
+		void WriteValue(const rapidjson::Value& jsonValue, FlatNode& flatNode) {
+			flatNode.count = 0;
+			flatNode.payload = 0;
+			if (jsonValue.IsObject()) {
+				flatNode.type = Object;
+				flatNode.count = jsonValue.MemberCount();
+				flatNode.payload = Allocate(sizeof(FlatMember) * flatNode.count);
+				std::vector<rapidjson::Value::ConstMemberIterator> sortedMembers;
+				sortedMembers.reserve(flatNode.count);
+				for (rapidjson::Value::ConstMemberIterator member = jsonValue.MemberBegin(); member != jsonValue.MemberEnd(); ++member) {
+					sortedMembers.push_back(member);
+				}
+				std::sort(sortedMembers.begin(), sortedMembers.end(), [](const rapidjson::Value::ConstMemberIterator& left, const rapidjson::Value::ConstMemberIterator& right) {
+					return CompareKeys(left->name.GetString(), left->name.GetStringLength(), right->name.GetString(), right->name.GetStringLength()) < 0;
+				});
+				for (size_t i = 0; i < sortedMembers.size(); i++) {
+					FlatMember flatMember;
+					flatMember.keyLength = sortedMembers[i]->name.GetStringLength();
+					flatMember.keyOffset = WriteString(sortedMembers[i]->name.GetString(), flatMember.keyLength);
+					flatMember.reserved = 0;
+					WriteValue(sortedMembers[i]->value, flatMember.value);
+					WriteBytes((size_t)flatNode.payload + i * sizeof(FlatMember), &flatMember, sizeof(flatMember));
+				}
+			}
+			else if (jsonValue.IsArray()) {
+				flatNode.type = Array;
+				flatNode.count = jsonValue.Size();
+				flatNode.payload = Allocate(sizeof(FlatNode) * flatNode.count);
+				for (rapidjson::SizeType i = 0; i < flatNode.count; i++) {
+					FlatNode element;
+					WriteValue(jsonValue[i], element);
+					WriteBytes((size_t)flatNode.payload + i * sizeof(FlatNode), &element, sizeof(element));
+				}
+			}
+			else if (jsonValue.IsString()) {
+				flatNode.type = String;
+				flatNode.count = jsonValue.GetStringLength();
+				flatNode.payload = WriteString(jsonValue.GetString(), flatNode.count);
+			}
+			else if (jsonValue.IsInt64()) {
+				flatNode.type = Int64;
+				flatNode.payload = (uint64_t)jsonValue.GetInt64();
+			}
+			else if (jsonValue.IsUint64()) {
+				flatNode.type = Uint64;
+				flatNode.payload = jsonValue.GetUint64();
+			}
+			else if (jsonValue.IsDouble()) {
+				flatNode.type = Double;
+				const double doubleValue = jsonValue.GetDouble();
+				std::memcpy(&flatNode.payload, &doubleValue, sizeof(doubleValue));
+			}
+			else if (jsonValue.IsBool()) {
+				flatNode.type = jsonValue.GetBool() ? True : False;
+			}
+			else {
+				flatNode.type = Null;
+			}
+		}
+	};
+
+	// Byte-wise ordering used for the sorted member tables
+	static int CompareKeys(const char* left, const size_t& leftLength, const char* right, const size_t& rightLength) {
+		const int comparison = std::memcmp(left, right, (leftLength < rightLength) ? leftLength : rightLength);
+		if (comparison != 0) {
+			return comparison;
+		}
+		return (leftLength < rightLength) ? -1 : ((leftLength > rightLength) ? 1 : 0);
+	}
+};
+
+// Publishes documents into shared memory under segmentName, each publish becomes a new version which attached readers switch to on Refresh().
+// The publisher must outlive the readers' need to attach, destroying it removes the segments' names but readers already attached keep working.
+// A publisher started under a name which is still published, say after a restart, carries on from the version already there
+class JsonSharedPublisher {
+public:
+	// Constructors & Deconstructors
+	JsonSharedPublisher(const std::string& segmentName) : segmentName(segmentName) {}
+	~JsonSharedPublisher() {
+		if (currentVersion != 0) {
+			SharedMemorySegment::Remove(JsonSharedLayout::DataSegmentName(segmentName, currentVersion));
+		}
+		if (controlSegment.IsOpen()) {
+			SharedMemorySegment::Remove(segmentName);
+		}
+	}
+	JsonSharedPublisher(const JsonSharedPublisher&) = delete;
+	JsonSharedPublisher& operator=(const JsonSharedPublisher&) = delete;
+
+	// Flattens jsonValue into a new data segment then makes it the current version, returns false if nothing was published
+	bool Publish(const rapidjson::Value& jsonValue) {
+		if (!controlSegment.IsOpen() && !OpenControlSegment()) {
+			return false;
+		}
+		const uint64_t newVersion = currentVersion + 1;
+		JsonSharedLayout::Writer sizingWriter(nullptr);
+		sizingWriter.WriteDocument(jsonValue, newVersion);
+		std::unique_ptr<SharedMemorySegment> newDataSegment(new SharedMemorySegment());
+		if (!newDataSegment->Create(JsonSharedLayout::DataSegmentName(segmentName, newVersion), sizingWriter.Size())) {
+			return false;
+		}
+		JsonSharedLayout::Writer dataWriter(newDataSegment->Data());
+		dataWriter.WriteDocument(jsonValue, newVersion);
+
+		// The data is complete before the version is released, so a reader which sees the new version always sees a whole document
+		reinterpret_cast<JsonSharedLayout::ControlBlock*>(controlSegment.Data())->version.store(newVersion, std::memory_order_release);
+		if (currentVersion != 0) {
+			SharedMemorySegment::Remove(JsonSharedLayout::DataSegmentName(segmentName, currentVersion));
+		}
+		currentVersion = newVersion;
+		currentDataSegment = std::move(newDataSegment);		// Held so the Windows mapping stays alive for readers yet to attach
+		std::cout << "JsonSharedDocument.hpp >>>> Segment: " << segmentName << " version " << newVersion << " was published, " << sizingWriter.Size() << " bytes" << std::endl;
+		return true;
+	}
+
+	// Accessors
+	const uint64_t GetVersion(void) const {
+		return currentVersion;
+	}
+	const std::string& GetSegmentName(void) const {
+		return segmentName;
+	}
+
+private:
+	std::string segmentName = "";
+	SharedMemorySegment controlSegment;
+	std::unique_ptr<SharedMemorySegment> currentDataSegment;
+	uint64_t currentVersion = 0;
+
+	// Picks up the control segment a previous publisher left behind and carries on from its version, readers may still be attached to it.
+	// Only when there is none, or it is not one of ours, is a fresh control segment created
+	bool OpenControlSegment(void) {
+		if (controlSegment.Open(segmentName, true)) {
+			if (controlSegment.Size() >= sizeof(JsonSharedLayout::ControlBlock) && std::memcmp(controlSegment.Data(), JsonSharedLayout::ControlMagic(), 8) == 0) {
+				currentVersion = reinterpret_cast<JsonSharedLayout::ControlBlock*>(controlSegment.Data())->version.load(std::memory_order_acquire);
+				std::cout << "JsonSharedDocument.hpp >>>> Segment: " << segmentName << " was reopened at version " << currentVersion << std::endl;
+				return true;
+			}
+			controlSegment.Close();
+		}
+		if (!controlSegment.Create(segmentName, sizeof(JsonSharedLayout::ControlBlock))) {
+			return false;
+		}
+		JsonSharedLayout::ControlBlock* controlBlock = new (controlSegment.Data()) JsonSharedLayout::ControlBlock();
+		std::memcpy(controlBlock->magic, JsonSharedLayout::ControlMagic(), 8);
+		controlBlock->version.store(0);
+		return true;
+	}
+};
+
+// Read-only view of a document published by a JsonSharedPublisher, possibly in another process.
+// Reads come straight out of the shared mapping, Refresh() switches to the newest version without disturbing reads already in progress
+class JsonSharedDocument {
+public:
+	// Constructors & Deconstructors
+	JsonSharedDocument(void) {}
+	JsonSharedDocument(const std::string& segmentName) {
+		Attach(segmentName);
+	}
+	JsonSharedDocument(const JsonSharedDocument&) = delete;
+	JsonSharedDocument& operator=(const JsonSharedDocument&) = delete;
+
+	bool Attach(const std::string& segmentName) {
+		Detach();
+		this->segmentName = segmentName;
+		// Mapped read-only, the version is only ever loaded here and ControlBlock requires lock-free 64 bit atomics so loading it never writes
+		if (!controlSegment.Open(segmentName, false) || controlSegment.Size() < sizeof(JsonSharedLayout::ControlBlock) || std::memcmp(controlSegment.Data(), JsonSharedLayout::ControlMagic(), 8) != 0) {
+			std::cout << "JsonSharedDocument.hpp >>>> Segment: " << segmentName << " has not been published" << std::endl;
+			controlSegment.Close();
+			return false;
+		}
+		Refresh();
+		return IsLoaded();
+	}
+	void Detach(void) {
+		std::atomic_store(&currentMapping, std::shared_ptr<const Mapping>());
+		controlSegment.Close();
+	}
+	// Switches to the newest published version, returns true if the version changed
+	bool Refresh(void) {
+		if (!controlSegment.IsOpen()) {
+			std::cout << "JsonSharedDocument.hpp >>>> Not attached to a segment, cannot call Refresh()" << std::endl;
+			return false;
+		}
+		const JsonSharedLayout::ControlBlock* controlBlock = reinterpret_cast<const JsonSharedLayout::ControlBlock*>(controlSegment.Data());
+		// The publisher removes a version as soon as it replaces it, so if we lose that race go again with the newer version
+		for (int attempt = 0; attempt < 8; attempt++) {
+			const uint64_t publishedVersion = controlBlock->version.load(std::memory_order_acquire);
+			if (publishedVersion == 0) {
+				return false;
+			}
+			std::shared_ptr<const Mapping> mapping = std::atomic_load(&currentMapping);
+			if (mapping != nullptr && mapping->version == publishedVersion) {
+				return false;
+			}
+			std::shared_ptr<Mapping> newMapping = std::make_shared<Mapping>();
+			if (newMapping->dataSegment.Open(JsonSharedLayout::DataSegmentName(segmentName, publishedVersion), false) && IsValidData(newMapping->dataSegment)) {
+				newMapping->version = publishedVersion;
+				newMapping->header = reinterpret_cast<const JsonSharedLayout::DataHeader*>(newMapping->dataSegment.Data());
+				std::atomic_store(&currentMapping, std::shared_ptr<const Mapping>(newMapping));
+				return true;
+			}
+		}
+		std::cout << "JsonSharedDocument.hpp >>>> Segment: " << segmentName << " could not be refreshed" << std::endl;
+		return false;
+	}
+
+	// Accessors
+	const bool IsLoaded(void) const {
+		return std::atomic_load(&currentMapping) != nullptr;
+	}
+	const uint64_t GetVersion(void) const {
+		std::shared_ptr<const Mapping> mapping = std::atomic_load(&currentMapping);
+		return (mapping != nullptr) ? mapping->version : 0;
+	}
+
+	// Get functions, these mirror the read-only half of the JsonFile API. Each call pins the version it started on for its whole length
+	template<typename T> inline T Get(const std::string& objectName) {
+		std::shared_ptr<const Mapping> mapping = std::atomic_load(&currentMapping);
+		const JsonSharedLayout::FlatNode* flatNode = FindNode(mapping, objectName, "Get<T>()");
+		if (flatNode == nullptr) {
+			return T();
+		}
+		if (flatNode->type == JsonSharedLayout::Object) {
+			std::cout << "JsonSharedDocument.hpp >>>> " << objectName << " is an object" << std::endl;
+			return T();
+		}
+		T value = T();
+		ReadValue(*mapping, *flatNode, value);
+		return value;
+	}
+	template<typename T> inline std::vector<T> GetVector(const std::string& objectName) {
+		std::vector<T> result;
+		std::shared_ptr<const Mapping> mapping = std::atomic_load(&currentMapping);
+		const JsonSharedLayout::FlatNode* flatNode = FindNode(mapping, objectName, "GetVector<T>()");
+		if (flatNode == nullptr) {
+			return result;
+		}
+		if (flatNode->type != JsonSharedLayout::Array) {
+			std::cout << "JsonSharedDocument.hpp >>>> " << objectName << " is not an array" << std::endl;
+			return result;
+		}
+		const JsonSharedLayout::FlatNode* elements = mapping->At<JsonSharedLayout::FlatNode>(flatNode->payload, flatNode->count);
+		if (elements == nullptr) {
+			return result;
+		}
+		result.resize(flatNode->count);
+		for (uint32_t i = 0; i < flatNode->count; i++) {
+			ReadValue(*mapping, elements[i], result[i]);
+		}
+		return result;
+	}
+	const size_t SizeOfObjectArray(const std::string& objectName) {
+		std::shared_ptr<const Mapping> mapping = std::atomic_load(&currentMapping);
+		const JsonSharedLayout::FlatNode* flatNode = FindNode(mapping, objectName, "SizeOfObjectArray()");
+		if (flatNode == nullptr) {
+			return 0;
+		}
+		if (flatNode->type != JsonSharedLayout::Array) {
+			std::cout << "JsonSharedDocument.hpp >>>> " << objectName << " is not an array" << std::endl;
+			return 0;
+		}
+		return flatNode->count;
+	}
+
+private:
+	// One mapped version, kept alive by every read using it
+	struct Mapping {
+		SharedMemorySegment dataSegment;
+		uint64_t version = 0;
+		const JsonSharedLayout::DataHeader* header = nullptr;
+
+		// Bounds-checked pointer to count Ts at offset, so a bad offset gives a failed lookup rather than a crash
+		template<typename T> const T* At(const uint64_t& offset, const uint64_t& count) const {
+			if (offset > header->segmentSize || count > (header->segmentSize - offset) / sizeof(T)) {
+				std::cout << "JsonSharedDocument.hpp >>>> Segment version " << version << " is corrupt" << std::endl;
+				return nullptr;
+			}
+			return reinterpret_cast<const T*>(dataSegment.Data() + offset);
+		}
+	};
+
+	std::string segmentName = "";
+	SharedMemorySegment controlSegment;
+	std::shared_ptr<const Mapping> currentMapping;	// Only accessed through std::atomic_load()/std::atomic_store()
+
+	static bool IsValidData(const SharedMemorySegment& dataSegment) {
+		if (dataSegment.Size() < sizeof(JsonSharedLayout::DataHeader) || std::memcmp(dataSegment.Data(), JsonSharedLayout::DataMagic(), 8) != 0) {
+			return false;
+		}
+		return reinterpret_cast<const JsonSharedLayout::DataHeader*>(dataSegment.Data())->segmentSize <= dataSegment.Size();
+	}
+
+	// Follows objectName's keys and indexes from the root, reporting failures the same way JsonFile does
+	const JsonSharedLayout::FlatNode* FindNode(const std::shared_ptr<const Mapping>& mapping, const std::string& objectName, const char* functionName) {
+		if (objectName == "") {
+			std::cout << "JsonSharedDocument.hpp >>>> No key was defined for " << functionName << " to use for traversal" << std::endl;
+			return nullptr;
+		}
+		if (mapping == nullptr) {
+			std::cout << "JsonSharedDocument.hpp >>>> Document is not loaded, cannot call " << functionName << std::endl;
+			return nullptr;
+		}
+		const JsonSharedLayout::FlatNode* flatNode = &mapping->header->root;
+		size_t keyStart = 0;
+		while (flatNode != nullptr && keyStart <= objectName.size()) {
+			size_t keyEnd = objectName.find('.', keyStart);
+			if (keyEnd == std::string::npos) {
+				keyEnd = objectName.size();
+			}
+			const std::string key = objectName.substr(keyStart, keyEnd - keyStart);
+			flatNode = FindChild(*mapping, *flatNode, key, objectName);
+			keyStart = keyEnd + 1;
+		}
+		return flatNode;
+	}
+	const JsonSharedLayout::FlatNode* FindChild(const Mapping& mapping, const JsonSharedLayout::FlatNode& flatNode, const std::string& key, const std::string& objectName) {
+		if (flatNode.type == JsonSharedLayout::Object) {
+			const JsonSharedLayout::FlatMember* members = mapping.At<JsonSharedLayout::FlatMember>(flatNode.payload, flatNode.count);
+			if (members == nullptr) {
+				return nullptr;
+			}
+			// Binary search the sorted member table
+			size_t low = 0;
+			size_t high = flatNode.count;
+			while (low < high) {
+				const size_t middle = low + (high - low) / 2;
+				const char* memberKey = mapping.At<char>(members[middle].keyOffset, members[middle].keyLength);
+				if (memberKey == nullptr) {
+					return nullptr;
+				}
+				const int comparison = JsonSharedLayout::CompareKeys(memberKey, members[middle].keyLength, key.c_str(), key.size());
+				if (comparison == 0) {
+					return &members[middle].value;
+				}
+				if (comparison < 0) {
+					low = middle + 1;
+				}
+				else {
+					high = middle;
+				}
+			}
+			std::cout << "JsonSharedDocument.hpp >>>> Could not find key: " << key << std::endl;
+			return nullptr;
+		}
+		if (flatNode.type == JsonSharedLayout::Array) {
+			char* parseEnd = nullptr;
+			const unsigned long indexOfValue = std::strtoul(key.c_str(), &parseEnd, 10);
+			if (key == "" || *parseEnd != '\0') {
+				std::cout << "JsonSharedDocument.hpp >>>> " << objectName << " " << key << " is invalid as an index value" << std::endl;
+				return nullptr;
+			}
+			if (indexOfValue >= flatNode.count) {
+				std::cout << "JsonSharedDocument.hpp >>>> " << objectName << " index: " << indexOfValue << " is out of bounds" << std::endl;
+				return nullptr;
+			}
+			const JsonSharedLayout::FlatNode* elements = mapping.At<JsonSharedLayout::FlatNode>(flatNode.payload, flatNode.count);
+			return (elements != nullptr) ? &elements[indexOfValue] : nullptr;
+		}
+		std::cout << "JsonSharedDocument.hpp >>>> Could not find key: " << key << std::endl;
+		return nullptr;
+	}
+
+	static double DoubleOf(const JsonSharedLayout::FlatNode& flatNode) {
+		double doubleValue = 0.0;
+		std::memcpy(&doubleValue, &flatNode.payload, sizeof(doubleValue));
+		return doubleValue;
+	}
+
+	// Value readers, these follow the same typing rules as JsonFile's GetValue<T>()
+	static bool ReadValue(const Mapping& mapping, const JsonSharedLayout::FlatNode& flatNode, int& value) {
+		const int64_t intValue = (int64_t)flatNode.payload;
+		if (flatNode.type != JsonSharedLayout::Int64 || intValue < INT32_MIN || intValue > INT32_MAX) {
+			std::cout << "JsonSharedDocument.hpp >>>> value is not an Int" << std::endl;
+			return false;
+		}
+		value = (int)intValue;
+		return true;
+	}
+	static bool ReadValue(const Mapping& mapping, const JsonSharedLayout::FlatNode& flatNode, float& value) {
+		const double doubleValue = DoubleOf(flatNode);
+		if (flatNode.type != JsonSharedLayout::Double || doubleValue < -3.4028234e38 || doubleValue > 3.4028234e38) {
+			std::cout << "JsonSharedDocument.hpp >>>> value is not a float" << std::endl;
+			return false;
+		}
+		value = (float)doubleValue;
+		return true;
+	}
+	static bool ReadValue(const Mapping& mapping, const JsonSharedLayout::FlatNode& flatNode, double& value) {
+		if (flatNode.type != JsonSharedLayout::Double) {
+			std::cout << "JsonSharedDocument.hpp >>>> value is not a double" << std::endl;
+			return false;
+		}
+		value = DoubleOf(flatNode);
+		return true;
+	}
+	static bool ReadValue(const Mapping& mapping, const JsonSharedLayout::FlatNode& flatNode, std::string& value) {
+		const char* stringData = (flatNode.type == JsonSharedLayout::String) ? mapping.At<char>(flatNode.payload, flatNode.count) : nullptr;
+		if (stringData == nullptr) {
+			std::cout << "JsonSharedDocument.hpp >>>> value is not a std::string" << std::endl;
+			return false;
+		}
+		value.assign(stringData, flatNode.count);
+		return true;
+	}
+	static bool ReadValue(const Mapping& mapping, const JsonSharedLayout::FlatNode& flatNode, bool& value) {
+		if (flatNode.type != JsonSharedLayout::True && flatNode.type != JsonSharedLayout::False) {
+			std::cout << "JsonSharedDocument.hpp >>>> value is not a boolean" << std::endl;
+			return false;
+		}
+		value = (flatNode.type == JsonSharedLayout::True);
+		return true;
+	}
+};
+
+#endif
@@ -0,0 +1,182 @@
+#ifndef CPP_JSON_PARSER_JSONSTRINGPOOL_HPP_
+#define CPP_JSON_PARSER_JSONSTRINGPOOL_HPP_
+
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include "rapidjson/document.h"
+#include <rapidjson/reader.h>
+
+// Pool of unique strings that documents can reference instead of each holding their own copy.
+// The copies are packed into a chunked arena and indexed by pointer and length, so each unique string costs its bytes plus one index node.
+// Pooled strings stay valid until the pool is cleared, so the pool must outlive every document referencing it.
+class JsonStringPool {
+public:
+	// rapidjson stores strings up to this length inside the value itself, pooling them would save nothing
+	static const size_t kInlineStringLength = 13;
+
+	JsonStringPool(void) {}
+	JsonStringPool(const JsonStringPool&) = delete;
+	JsonStringPool& operator=(const JsonStringPool&) = delete;
+
+	// Returns the pooled copy of the string, adding it if this is the first time it has been seen
+	const char* Intern(const char* stringToIntern, const size_t& length) {
+		internedReferences++;
+		referencedBytes += AlignedSize(length + 1);	// What the document's allocator would have spent on its own copy
+		std::unordered_set<PooledString, PooledStringHash, PooledStringEqual>::iterator existing = strings.find(PooledString{ stringToIntern, length });
+		if (existing != strings.end()) {
+			return existing->data;
+		}
+		char* pooledCopy = static_cast<char*>(storage.Malloc(length + 1));
+		std::memcpy(pooledCopy, stringToIntern, length);
+		pooledCopy[length] = '\0';
+		strings.insert(PooledString{ pooledCopy, length });
+		pooledBytes += AlignedSize(length + 1);
+		return pooledCopy;	// The arena never moves or frees a copy, so this pointer is stable until Clear()
+	}
+	void Clear(void) {
+		strings.clear();
+		storage.Clear();
+		pooledBytes = 0;
+		internedReferences = 0;
+		referencedBytes = 0;
+	}
+
+	// Statistics
+	const size_t NumberOfStrings(void) const {
+		return strings.size();
+	}
+	const size_t NumberOfReferences(void) const {
+		return internedReferences;
+	}
+	// Bytes held by the pooled copies themselves
+	const size_t PooledBytes(void) const {
+		return pooledBytes;
+	}
+	// Everything the pool costs, the copies plus an estimate of the hash index's nodes and bucket array
+	const size_t PoolBytes(void) const {
+		return pooledBytes + strings.size() * kIndexNodeBytes + strings.bucket_count() * sizeof(void*);
+	}
+	// Bytes the document allocator would have used for its own copies, minus everything the pool costs. 0 when pooling cost more than it saved
+	const size_t BytesSaved(void) const {
+		const size_t poolBytes = PoolBytes();
+		return (referencedBytes > poolBytes) ? referencedBytes - poolBytes : 0;
+	}
+
+private:
+	struct PooledString {
+		const char* data;
+		size_t length;
+	};
+	// FNV-1a over the characters
+	struct PooledStringHash {
+		size_t operator()(const PooledString& pooledString) const {
+			size_t hash = (sizeof(size_t) == 8) ? (size_t)14695981039346656037ULL : (size_t)2166136261U;
+			const size_t prime = (sizeof(size_t) == 8) ? (size_t)1099511628211ULL : (size_t)16777619U;
+			for (size_t i = 0; i < pooledString.length; i++) {
+				hash = (hash ^ (unsigned char)pooledString.data[i]) * prime;
+			}
+			return hash;
+		}
+	};
+	struct PooledStringEqual {
+		bool operator()(const PooledString& left, const PooledString& right) const {
+			return left.length == right.length && std::memcmp(left.data, right.data, left.length) == 0;
+		}
+	};
+	// A typical unordered_set node, the key plus the next pointer and cached hash
+	static const size_t kIndexNodeBytes = sizeof(PooledString) + 2 * sizeof(void*);
+
+	// rapidjson's allocators round every allocation up to 8 bytes
+	static size_t AlignedSize(const size_t& size) {
+		return (size + 7) & ~(size_t)7;
+	}
+
+	std::unordered_set<PooledString, PooledStringHash, PooledStringEqual> strings;
+	rapidjson::MemoryPoolAllocator<> storage;
+	size_t pooledBytes = 0;
+	size_t internedReferences = 0;
+	size_t referencedBytes = 0;
+};
+
+// SAX handler which forwards every event to outputHandler, swapping object keys and short string values for pooled copies
+template<typename OutputHandler> class JsonInterningHandler {
+public:
+	JsonInterningHandler(OutputHandler& outputHandler, JsonStringPool& stringPool, const size_t& maxInternedValueLength) : outputHandler(outputHandler), stringPool(stringPool), maxInternedValueLength(maxInternedValueLength) {}
+
+	bool Null(void) {
+		return outputHandler.Null();
+	}
+	bool Bool(bool value) {
+		return outputHandler.Bool(value);
+	}
+	bool Int(int value) {
+		return outputHandler.Int(value);
+	}
+	bool Uint(unsigned value) {
+		return outputHandler.Uint(value);
+	}
+	bool Int64(int64_t value) {
+		return outputHandler.Int64(value);
+	}
+	bool Uint64(uint64_t value) {
+		return outputHandler.Uint64(value);
+	}
+	bool Double(double value) {
+		return outputHandler.Double(value);
+	}
+	bool RawNumber(const char* value, rapidjson::SizeType length, bool copy) {
+		return outputHandler.RawNumber(value, length, copy);
+	}
+	bool String(const char* value, rapidjson::SizeType length, bool copy) {
+		if (length > JsonStringPool::kInlineStringLength && length <= maxInternedValueLength) {
+			return outputHandler.String(stringPool.Intern(value, length), length, false);
+		}
+		return outputHandler.String(value, length, copy);
+	}
+	bool StartObject(void) {
+		return outputHandler.StartObject();
+	}
+	bool Key(const char* key, rapidjson::SizeType length, bool copy) {
+		if (length > JsonStringPool::kInlineStringLength) {
+			return outputHandler.Key(stringPool.Intern(key, length), length, false);
+		}
+		return outputHandler.Key(key, length, copy);
+	}
+	bool EndObject(rapidjson::SizeType memberCount) {
+		return outputHandler.EndObject(memberCount);
+	}
+	bool StartArray(void) {
+		return outputHandler.StartArray();
+	}
+	bool EndArray(rapidjson::SizeType elementCount) {
+		return outputHandler.EndArray(elementCount);
+	}
+
+private:
+	OutputHandler& outputHandler;
+	JsonStringPool& stringPool;
+	size_t maxInternedValueLength;
+};
+
+// Generator for rapidjson::Document::Populate() which parses inputStream through a JsonInterningHandler, any GenericDocument can be populated
+template<typename InputStream> class JsonInterningGenerator {
+public:
+	JsonInterningGenerator(InputStream& inputStream, JsonStringPool& stringPool, const size_t& maxInternedValueLength) : inputStream(inputStream), stringPool(stringPool), maxInternedValueLength(maxInternedValueLength) {}
+
+	template<typename Document> bool operator()(Document& jsonDocument) {
+		JsonInterningHandler<Document> interningHandler(jsonDocument, stringPool, maxInternedValueLength);
+		rapidjson::Reader reader;
+		parseResult = reader.Parse(inputStream, interningHandler);
+		return !parseResult.IsError();
+	}
+
+	rapidjson::ParseResult parseResult;
+
+private:
+	InputStream& inputStream;
+	JsonStringPool& stringPool;
+	size_t maxInternedValueLength;
+};
+
+#endif
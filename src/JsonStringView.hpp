@@ -0,0 +1,64 @@
+#ifndef CPP_JSON_PARSER_JSONSTRINGVIEW_HPP_
+#define CPP_JSON_PARSER_JSONSTRINGVIEW_HPP_
+
+#include <cstring>
+#include <string>
+#include <ostream>
+
+// A non-owning view of a string stored inside a JsonFile's document, modelled on std::string_view so it works under C++11.
+// The view stays valid until the value it points at is changed or the document is re-loaded.
+class JsonStringView {
+public:
+	// Constructors
+	JsonStringView(void) : viewData(""), viewLength(0) {}
+	JsonStringView(const char* data, const size_t& length) : viewData(data), viewLength(length) {}
+	JsonStringView(const char* data) : viewData(data), viewLength(std::strlen(data)) {}
+	explicit JsonStringView(const std::string& data) : viewData(data.c_str()), viewLength(data.length()) {}
+	JsonStringView(std::string&& data) = delete;	// A view of a temporary would dangle as soon as the statement ends
+
+	// Accessors
+	const char* data(void) const {
+		return viewData;
+	}
+	size_t size(void) const {
+		return viewLength;
+	}
+	size_t length(void) const {
+		return viewLength;
+	}
+	bool empty(void) const {
+		return viewLength == 0;
+	}
+	const char* begin(void) const {
+		return viewData;
+	}
+	const char* end(void) const {
+		return viewData + viewLength;
+	}
+	char operator[](const size_t& index) const {
+		return viewData[index];
+	}
+
+	// Copies the viewed characters out into an owning std::string
+	std::string ToString(void) const {
+		return std::string(viewData, viewLength);
+	}
+
+	// Comparisons
+	bool operator==(const JsonStringView& other) const {
+		return viewLength == other.viewLength && (viewLength == 0 || std::memcmp(viewData, other.viewData, viewLength) == 0);
+	}
+	bool operator!=(const JsonStringView& other) const {
+		return !(*this == other);
+	}
+
+private:
+	const char* viewData;
+	size_t viewLength;
+};
+
+inline std::ostream& operator<<(std::ostream& outputStream, const JsonStringView& view) {
+	return outputStream.write(view.data(), view.size());
+}
+
+#endif
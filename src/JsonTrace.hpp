@@ -0,0 +1,266 @@
+#ifndef CPP_JSON_PARSER_JSONTRACE_HPP_
+#define CPP_JSON_PARSER_JSONTRACE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "rapidjson/document.h"
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/writer.h>
+
+// Scoped trace events for building a timeline of what JsonFile was doing, exported as Chrome trace-event JSON for chrome://tracing or Perfetto.
+// Define JSONFILE_ENABLE_TRACING before including JsonParser.hpp to turn them on, otherwise the macros below compile to nothing.
+//   JSON_TRACE_SCOPE(name, fileName, path)	Times from here to the end of the enclosing block, one per block
+//   JSON_TRACE_BYTES(bytes)					Sets the byte count of the enclosing block's event, bytes isn't evaluated when tracing is off
+#ifdef JSONFILE_ENABLE_TRACING
+#define JSON_TRACE_SCOPE(name, fileName, path) JsonTraceScope jsonTraceScope(name, fileName, path)
+#define JSON_TRACE_BYTES(bytes) jsonTraceScope.SetBytes(bytes)
+#else
+#define JSON_TRACE_SCOPE(name, fileName, path)
+#define JSON_TRACE_BYTES(bytes)
+#endif
+
+// Number of events each thread keeps, older events are overwritten once a thread's ring is full
+#ifndef JSONFILE_TRACE_BUFFER_EVENTS
+#define JSONFILE_TRACE_BUFFER_EVENTS 4096
+#endif
+// Number of exited threads whose rings are kept until they are exported, the oldest are dropped past this so short-lived threads can't grow memory forever
+#ifndef JSONFILE_TRACE_EXITED_THREADS
+#define JSONFILE_TRACE_EXITED_THREADS 16
+#endif
+
+class JsonTrace {
+public:
+	static const size_t kFileNameLength = 48;
+	static const size_t kPathLength = 96;
+
+	// A single completed scope, strings are truncated copies so recording never allocates
+	struct Event {
+		std::atomic<uint64_t> sequence;		// Index + 1 of the write that filled this slot, 0 while it is being written
+		const char* name;					// Always a string literal
+		uint64_t startMicroseconds;
+		uint64_t durationMicroseconds;
+		uint64_t bytes;
+		char fileName[kFileNameLength];
+		char path[kPathLength];
+	};
+
+	// Records an event into the calling thread's ring, only the owning thread ever writes to a ring so this takes no locks
+	static void Record(const char* name, const char* fileName, const char* path, const uint64_t& startMicroseconds, const uint64_t& durationMicroseconds, const uint64_t& bytes) {
+		ThreadBuffer& threadBuffer = CurrentThreadBuffer();
+		const uint64_t writeIndex = threadBuffer.writeIndex.load(std::memory_order_relaxed);
+		Event& event = threadBuffer.events[writeIndex % JSONFILE_TRACE_BUFFER_EVENTS];
+		event.sequence.store(0, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		event.name = name;
+		event.startMicroseconds = startMicroseconds;
+		event.durationMicroseconds = durationMicroseconds;
+		event.bytes = bytes;
+		std::memcpy(event.fileName, fileName, sizeof(event.fileName));
+		std::memcpy(event.path, path, sizeof(event.path));
+		event.sequence.store(writeIndex + 1, std::memory_order_release);
+		threadBuffer.writeIndex.store(writeIndex + 1, std::memory_order_release);
+	}
+	// Microseconds since the first trace timestamp was taken, shared by every thread so their events line up
+	static uint64_t NowMicroseconds(void) {
+		static const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+		return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - traceEpoch).count();
+	}
+
+	// Writes every thread's retained events as a Chrome trace. Best called while nothing is being traced, slots overwritten mid-copy are skipped.
+	// Rings of threads which had exited before they were written out are dropped afterwards, as nothing more can be recorded into them
+	static bool WriteChromeTrace(const std::string& traceFileName) {
+		std::ofstream outFileStream(traceFileName);
+		if (!outFileStream.is_open()) {
+			std::cout << "JsonTrace.hpp >>>> File: " << traceFileName << " could not be opened for writing" << std::endl;
+			return false;
+		}
+		rapidjson::OStreamWrapper outputStreamWrapper(outFileStream);
+		rapidjson::Writer<rapidjson::OStreamWrapper> traceWriter(outputStreamWrapper);
+		traceWriter.StartObject();
+		traceWriter.Key("traceEvents");
+		traceWriter.StartArray();
+		std::vector<std::shared_ptr<ThreadBuffer>> exportedExitedBuffers;
+		for (const std::shared_ptr<ThreadBuffer>& threadBuffer : RegisteredBuffers()) {
+			// Checked before reading the ring, a thread which exits part way through the export may still have events we haven't seen
+			if (threadBuffer->hasThreadExited.load(std::memory_order_acquire)) {
+				exportedExitedBuffers.push_back(threadBuffer);
+			}
+			const uint64_t writeIndex = threadBuffer->writeIndex.load(std::memory_order_acquire);
+			const uint64_t firstIndex = (writeIndex > JSONFILE_TRACE_BUFFER_EVENTS) ? writeIndex - JSONFILE_TRACE_BUFFER_EVENTS : 0;
+			for (uint64_t i = firstIndex; i < writeIndex; i++) {
+				const Event& event = threadBuffer->events[i % JSONFILE_TRACE_BUFFER_EVENTS];
+				if (event.sequence.load(std::memory_order_acquire) != i + 1) {
+					continue;
+				}
+				const char* name = event.name;
+				const uint64_t startMicroseconds = event.startMicroseconds;
+				const uint64_t durationMicroseconds = event.durationMicroseconds;
+				const uint64_t bytes = event.bytes;
+				char fileName[sizeof(event.fileName)];
+				char path[sizeof(event.path)];
+				std::memcpy(fileName, event.fileName, sizeof(fileName));
+				std::memcpy(path, event.path, sizeof(path));
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (event.sequence.load(std::memory_order_relaxed) != i + 1) {
+					continue;
+				}
+				// Complete ("X") events carry their own duration, so nesting shows up without matching begin/end pairs
+				traceWriter.StartObject();
+				traceWriter.Key("name");
+				traceWriter.String(name);
+				traceWriter.Key("cat");
+				traceWriter.String("JsonFile");
+				traceWriter.Key("ph");
+				traceWriter.String("X");
+				traceWriter.Key("ts");
+				traceWriter.Uint64(startMicroseconds);
+				traceWriter.Key("dur");
+				traceWriter.Uint64(durationMicroseconds);
+				traceWriter.Key("pid");
+				traceWriter.Uint(1);
+				traceWriter.Key("tid");
+				traceWriter.Uint(threadBuffer->threadId);
+				traceWriter.Key("args");
+				traceWriter.StartObject();
+				traceWriter.Key("file");
+				traceWriter.String(fileName);
+				traceWriter.Key("path");
+				traceWriter.String(path);
+				traceWriter.Key("bytes");
+				traceWriter.Uint64(bytes);
+				traceWriter.EndObject();
+				traceWriter.EndObject();
+			}
+		}
+		traceWriter.EndArray();
+		traceWriter.Key("displayTimeUnit");
+		traceWriter.String("ms");
+		traceWriter.EndObject();
+		const bool isWritten = outFileStream.good();
+		if (isWritten) {
+			std::lock_guard<std::mutex> registryLock(RegistryMutex());
+			std::vector<std::shared_ptr<ThreadBuffer>>& registry = Registry();
+			for (const std::shared_ptr<ThreadBuffer>& exitedBuffer : exportedExitedBuffers) {
+				registry.erase(std::remove(registry.begin(), registry.end(), exitedBuffer), registry.end());
+			}
+		}
+		return isWritten;
+	}
+	// Drops every recorded event, and the rings of threads which have exited, only safe while nothing is being traced
+	static void Clear(void) {
+		for (const std::shared_ptr<ThreadBuffer>& threadBuffer : RegisteredBuffers()) {
+			for (Event& event : threadBuffer->events) {
+				event.sequence.store(0, std::memory_order_relaxed);
+			}
+			threadBuffer->writeIndex.store(0, std::memory_order_release);
+		}
+		std::lock_guard<std::mutex> registryLock(RegistryMutex());
+		DropExitedBuffers(0);
+	}
+
+private:
+	struct ThreadBuffer {
+		ThreadBuffer(const uint32_t& threadId) : threadId(threadId) {
+			for (Event& event : events) {
+				event.sequence.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		Event events[JSONFILE_TRACE_BUFFER_EVENTS];
+		std::atomic<uint64_t> writeIndex{ 0 };
+		std::atomic<bool> hasThreadExited{ false };
+		uint32_t threadId;		// Small sequential id, easier to read in a trace viewer than a native thread id
+	};
+	// Held in thread-local storage so the ring is marked as exited when its thread ends, the registry keeps the ring itself alive
+	struct ThreadBufferOwner {
+		~ThreadBufferOwner() {
+			if (threadBuffer != nullptr) {
+				threadBuffer->hasThreadExited.store(true, std::memory_order_release);
+			}
+		}
+
+		ThreadBuffer* threadBuffer = nullptr;
+	};
+
+	static std::mutex& RegistryMutex(void) {
+		static std::mutex registryMutex;
+		return registryMutex;
+	}
+	static std::vector<std::shared_ptr<ThreadBuffer>>& Registry(void) {
+		static std::vector<std::shared_ptr<ThreadBuffer>> registry;
+		return registry;
+	}
+	// Copy of the registry so the rings can be walked without holding the lock
+	static std::vector<std::shared_ptr<ThreadBuffer>> RegisteredBuffers(void) {
+		std::lock_guard<std::mutex> registryLock(RegistryMutex());
+		return Registry();
+	}
+	// Removes all but the newest exitedToKeep rings of exited threads, the caller must hold the registry lock
+	static void DropExitedBuffers(const size_t& exitedToKeep) {
+		std::vector<std::shared_ptr<ThreadBuffer>>& registry = Registry();
+		size_t exitedCount = 0;
+		for (std::vector<std::shared_ptr<ThreadBuffer>>::iterator threadBuffer = registry.end(); threadBuffer != registry.begin();) {
+			--threadBuffer;
+			if ((*threadBuffer)->hasThreadExited.load(std::memory_order_acquire) && ++exitedCount > exitedToKeep) {
+				threadBuffer = registry.erase(threadBuffer);
+			}
+		}
+	}
+	// The lock is only taken the first time each thread records, rings are kept after their thread exits so its events can still be exported.
+	// Registering is also when the oldest unexported rings of exited threads are dropped, once there are more than JSONFILE_TRACE_EXITED_THREADS of them
+	static ThreadBuffer& CurrentThreadBuffer(void) {
+		thread_local ThreadBufferOwner threadBufferOwner;
+		if (threadBufferOwner.threadBuffer == nullptr) {
+			static uint32_t nextThreadId = 1;
+			std::lock_guard<std::mutex> registryLock(RegistryMutex());
+			DropExitedBuffers(JSONFILE_TRACE_EXITED_THREADS);
+			std::shared_ptr<ThreadBuffer> newBuffer = std::make_shared<ThreadBuffer>(nextThreadId++);
+			Registry().push_back(newBuffer);
+			threadBufferOwner.threadBuffer = newBuffer.get();
+		}
+		return *threadBufferOwner.threadBuffer;
+	}
+};
+
+// Times its own lifetime and records it as a single event, used through JSON_TRACE_SCOPE
+class JsonTraceScope {
+public:
+	JsonTraceScope(const char* name, const std::string& fileName, const std::string& path) : name(name) {
+		CopyTruncated(this->fileName, sizeof(this->fileName), fileName);
+		CopyTruncated(this->path, sizeof(this->path), path);
+		startMicroseconds = JsonTrace::NowMicroseconds();
+	}
+	~JsonTraceScope() {
+		JsonTrace::Record(name, fileName, path, startMicroseconds, JsonTrace::NowMicroseconds() - startMicroseconds, bytes);
+	}
+	JsonTraceScope(const JsonTraceScope&) = delete;
+	JsonTraceScope& operator=(const JsonTraceScope&) = delete;
+
+	void SetBytes(const uint64_t& bytes) {
+		this->bytes = bytes;
+	}
+
+private:
+	const char* name;
+	char fileName[JsonTrace::kFileNameLength];	// Copied up front, the strings passed in may not outlive the scope
+	char path[JsonTrace::kPathLength];
+	uint64_t startMicroseconds = 0;
+	uint64_t bytes = 0;
+
+	static void CopyTruncated(char* destination, const size_t& destinationSize, const std::string& source) {
+		const size_t length = (source.size() < destinationSize - 1) ? source.size() : destinationSize - 1;
+		std::memcpy(destination, source.data(), length);
+		std::memset(destination + length, 0, destinationSize - length);
+	}
+};
+
+#endif
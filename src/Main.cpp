@@ -1,8 +1,9 @@
 #include "JsonParser.hpp"
+#include "JsonFileRegistry.hpp"
 
 int main() {
 	// Load the File
-	JsonFile testFileForGets = JsonFile("content/get_test.json");
+	JsonFile testFileForGets("content/get_test.json");
 	
 	// Get<T>() Tests
 	int getIntTest = testFileForGets.Get<int>("value test.int");
@@ -24,9 +25,66 @@ int main() {
 	std::vector<double> getDoubleArrayTest = testFileForGets.GetVector<double>("array test.double array");
 	std::vector<std::string> getStringArrayTest = testFileForGets.GetVector<std::string>("array test.string array");
 	std::vector<bool> getBoolArrayTest = testFileForGets.GetVector<bool>("array test.boolean array");
+
+	// GetView() Tests
+	JsonStringView getStringViewTest = testFileForGets.GetView("value test.string");
+	std::vector<JsonStringView> getStringViewArrayTest = testFileForGets.GetViewVector("array test.string array");
+
+	// GetArrayView<T>() Tests
+	JsonFile::ArrayView<int> intArrayViewTest = testFileForGets.GetArrayView<int>("array test.int array");
+	int intArrayViewSumTest = 0;
+	for (int item : intArrayViewTest) {
+		intArrayViewSumTest += item;
+	}
+	size_t intArrayViewSizeTest = intArrayViewTest.size();
+	std::vector<int> intArrayViewSliceTest = intArrayViewTest.Slice(2, 3).ToVector();
+	float floatArrayViewAtTest = testFileForGets.GetArrayView<float>("array test.float array").At(10);	// Will fail because the index is out of bounds
+
+
+	// Query<T>() Tests
+	JsonFile testFileForQueries("content/engine.json");
+	std::vector<std::string> queryWildcardTest = testFileForQueries.Query<std::string>("engine.key bindings.*.binding.id");
+	std::vector<int> queryRangeTest = testFileForQueries.Query<int>("engine.key bindings.1:3.binding.key value");
+	std::vector<JsonStringView> queryFilterTest = testFileForQueries.Query<JsonStringView>("engine.key bindings.[binding.key value>=10].binding.friendly name");
+	std::vector<int> queryObjectWildcardTest = testFileForQueries.Query<int>("engine.window.*.width");
+	std::vector<int> queryBadOperatorTest = testFileForQueries.Query<int>("engine.key bindings.[binding.key value==10].binding.key value");	// Will fail because == isn't an operator
+
+
+	// GetMany() Tests
+	std::string getManyTitleTest;
+	int getManyTileWidthTest = 0;
+	int getManyTileHeightTest = 0;
+	bool getManyVsyncTest = false;
+	float getManyMissingTest = 0.0f;
+	std::vector<JsonFile::BatchEntry> getManyEntries;
+	getManyEntries.push_back(JsonFile::MakeBatchEntry("engine.window.title", &getManyTitleTest));
+	getManyEntries.push_back(JsonFile::MakeBatchEntry("engine.window.tile size.width", &getManyTileWidthTest));
+	getManyEntries.push_back(JsonFile::MakeBatchEntry("engine.window.tile size.height", &getManyTileHeightTest));
+	getManyEntries.push_back(JsonFile::MakeBatchEntry("engine.vsync", &getManyVsyncTest));
+	getManyEntries.push_back(JsonFile::MakeBatchEntry("engine.window.missing", &getManyMissingTest));	// Will be marked NotFound
+	size_t getManyFoundTest = testFileForQueries.GetMany(getManyEntries);
+
+
+	// JsonFileRegistry Tests
+	JsonFileHandle registryHandleTest = JsonFileRegistry::Instance().Acquire("content/engine.json");
+	JsonFileHandle registrySharedHandleTest = JsonFileRegistry::Instance().Acquire("./content/engine.json");	// Shares the document loaded by the first handle
+	std::string registryTitleTest = registryHandleTest.Get<std::string>("engine.window.title");
+	size_t registryMemoryUsageTest = JsonFileRegistry::Instance().MemoryUsage();
+	{
+		JsonFilePin registryPinTest = registryHandleTest.Pin();
+		JsonFileRegistry::Instance().SetMemoryBudget(1);	// Evicts nothing, the only loaded document is pinned
+	}
+	JsonFileRegistry::Instance().EvictAll();	// Evicts every loaded document that isn't pinned, even ones which still have handles
+	int registryReloadTest = registrySharedHandleTest.Get<int>("engine.window.tile size.width");	// Transparently re-loads the evicted document
+	JsonFileRegistry::Instance().SetMemoryBudget(0);
+	{
+		JsonFileHandle registryScopedHandleTest = JsonFileRegistry::Instance().Acquire("content/get_test.json");
+		bool registryScopedLoadedTest = registryScopedHandleTest.IsLoaded();
+	}
+	size_t registryReleasedTest = JsonFileRegistry::Instance().NumberOfLoadedDocuments();	// Back to 1, releasing the scoped handle dropped its document
 	
 	// Load the File
-	JsonFile testFileForSets = JsonFile("content/set_test.json");
+	JsonFile testFileForSets("content/set_test.json");
 	testFileForSets.Set<int>("value test.int", 111);
 	testFileForSets.Set<float>("value test.float", 101.89f);
 	testFileForSets.Set<double>("value test.double", 901.982);
@@ -63,17 +121,164 @@ int main() {
 	testFileForSets.Insert<int>("array test", "insert array int test", intVector);
 	testFileForSets.Insert<bool>("", "insert array bool test", boolVector);
 	testFileForSets.Insert<std::string>("", "insert array string test", stringVector);
+	testFileForSets.Insert("", "insert moved string test", std::string("moved example"));
 
 	testFileForSets.Remove("value test.int");
 	testFileForSets.Remove("array test.int array.2");
 
 
+	// Write-behind tests, the burst of Set<T>() calls is coalesced into a single write
+	testFileForSets.EnableWriteBehind(std::chrono::milliseconds(50));
+	for (int i = 0; i < 100; i++) {
+		testFileForSets.Set<int>("array test.int array.0", i);
+	}
+	bool writeBehindDirtyTest = testFileForSets.IsDirty();
+	std::future<bool> saveAsyncTest = testFileForSets.SaveAsync();
+	bool saveAsyncResultTest = saveAsyncTest.get();
+	testFileForSets.Set<int>("array test.int array.0", 0);
+	bool flushTest = testFileForSets.Flush();
+	testFileForSets.DisableWriteBehind();
+	std::future<bool> loadAsyncTest = testFileForSets.LoadAsync("content/set_test.json");
+	bool loadAsyncResultTest = loadAsyncTest.get();
+
+	// Snapshot tests
+	testFileForSets.EnableHistory(64);
+	size_t snapshotTest = testFileForSets.Snapshot();
+	testFileForSets.Set<float>("value test.float", 1.5f);
+	testFileForSets.Insert<int>("", "snapshot insert test", 1);
+	testFileForSets.Remove("array test.boolean array.0");
+	bool restoreTest = testFileForSets.Restore(snapshotTest);		// Puts back the float, removes the insert and re-adds the boolean
+	bool redoTest = testFileForSets.Redo();						// Re-applies the Set<float>()
+	bool undoTest = testFileForSets.Undo();
+	testFileForSets.EnableHistory(1);							// Shrinking the limit after an undo drops the newest redo entries first
+	bool redoAfterShrinkTest = testFileForSets.Redo();				// Only the Set<float>() is left to redo
+	testFileForSets.DisableHistory();
+
+	// Packed array tests
+	testFileForSets.EnablePackedArrays();
+	testFileForSets.InsertPacked<int>("", "insert packed int test", intVector, JsonFile::PackedType::Int16);
+	std::vector<int> getPackedIntTest = testFileForSets.GetVector<int>("insert packed int test");
+	size_t sizeOfPackedTest = testFileForSets.SizeOfObjectArray("insert packed int test");
+	testFileForSets.Set<int>("insert packed int test", getPackedIntTest);		// Stays packed as int16
+	std::vector<float> getPackedAsFloatTest = testFileForSets.GetVector<float>("insert packed int test");	// Will fail because the packed elements are integers
+	int getPackedElementTest = testFileForSets.Get<int>("insert packed int test.0");	// Will fail because packed elements can only be read with GetVector<T>()
+	std::vector<double> doubleVector(4, 0.25);
+	testFileForSets.SetPacked<double>("array test.double array", doubleVector, JsonFile::PackedType::Float32);
+	testFileForSets.InsertPacked<int>("", "insert packed overflow test", std::vector<int>(1, 1000), JsonFile::PackedType::Int8);	// Will fail because 1000 doesn't fit in an int8
+
+	// Change tracking tests
+	size_t versionTest = testFileForSets.GetVersion();
+	size_t changeNotificationsTest = 0;
+	size_t subscriptionTest = testFileForSets.Subscribe("value test", [&changeNotificationsTest](const std::string& changedPath, const size_t& version) {
+		changeNotificationsTest++;
+	});
+	testFileForSets.Set<float>("value test.float", 2.5f);
+	testFileForSets.Set<int>("array test.int array.0", 1);		// Outside the subscribed prefix, no notification
+	bool valueTestChangedTest = testFileForSets.HasChangedSince("value test", versionTest);
+	bool boolArrayChangedTest = testFileForSets.HasChangedSince("array test.boolean array", versionTest);	// False, only the int array changed
+	bool paddedIndexChangedTest = testFileForSets.HasChangedSince("array test.int array.00", versionTest);	// True, "00" is the same element as "0"
+	testFileForSets.Unsubscribe(subscriptionTest);
+
 	int sizeTestInt = testFileForGets.SizeOfObjectArray("array test.int array");
 	int sizeTestFloat = testFileForGets.SizeOfObjectArray("array test.float array");
 	int sizeTestDouble = testFileForGets.SizeOfObjectArray("array test.double ardray");
 	int sizeTestString = testFileForGets.SizeOfObjectArray("array test.string array.1");
 	int sizeTestBool = testFileForGets.SizeOfObjectArray("array test.boolean array");
 
+	// JsonArchive tests, content.pak is built from the content folder by the cpp-json-packer target
+	JsonArchive contentArchive("content.pak");
+	JsonFile testFileFromArchive(contentArchive, "content/engine.json");
+	std::string archiveTitleTest = testFileFromArchive.Get<std::string>("engine.window.title");
+	testFileFromArchive.Set<std::string>("engine.window.title", "changed");	// Changes the document in memory but can't be saved back into the archive
+
+	// Interning tests
+	JsonFile testFileForInterning;
+	testFileForInterning.EnableInterning(32);
+	testFileForInterning.Load("content/engine.json");
+	size_t internedStringsTest = testFileForInterning.GetStringPool().NumberOfStrings();
+	size_t internedBytesSavedTest = testFileForInterning.GetStringPool().BytesSaved();
+	std::string internedValueTest = testFileForInterning.Get<std::string>("engine.key bindings.0.binding.friendly name");
+
+	// Schema validation tests, the schema is compiled once and shared by every load that uses it
+	std::shared_ptr<const JsonSchema> engineSchema = JsonSchema::FromFile("content/engine.schema.json");
+	std::vector<JsonSchemaViolation> schemaViolationsTest;
+	JsonFile testFileForSchemas;
+	bool schemaValidLoadTest = testFileForSchemas.Load("content/engine.json", *engineSchema, &schemaViolationsTest);
+	bool schemaInvalidLoadTest = testFileForSchemas.Load("content/get_test.json", *engineSchema, &schemaViolationsTest);		// Will fail because get_test.json has no engine object
+	bool schemaContinueLoadTest = testFileForSchemas.Load("content/get_test.json", *engineSchema, &schemaViolationsTest, false);	// Reports the violation but still loads
+
+	// Parallel parse tests, the threshold is lowered so the level's tile grid is split across threads
+	JsonFile testFileForParallelParse;
+	testFileForParallelParse.EnableParallelParse(1024, 4);
+	testFileForParallelParse.Load("content/test_level.json");
+	size_t parallelTileCountTest = testFileForParallelParse.SizeOfObjectArray("level.tile grid");
+	std::vector<int> parallelTileGridTest = testFileForParallelParse.GetVector<int>("level.tile grid");
+	int parallelTileTest = testFileForParallelParse.Get<int>("level.tile grid.153");
+
+	// Columnar extraction tests, the presence bits mark which rows had a friendly name
+	std::vector<std::string> bindingIdColumnTest;
+	std::vector<int> bindingKeyValueColumnTest;
+	std::vector<JsonStringView> bindingNameColumnTest;
+	std::vector<bool> bindingNamePresenceTest;
+	std::vector<JsonFile::ColumnSpec> bindingColumns;
+	bindingColumns.push_back(JsonFile::MakeColumn("binding.id", &bindingIdColumnTest));
+	bindingColumns.push_back(JsonFile::MakeColumn("binding.key value", &bindingKeyValueColumnTest));
+	bindingColumns.push_back(JsonFile::MakeColumn("binding.friendly name", &bindingNameColumnTest, &bindingNamePresenceTest));
+	size_t bindingRowsTest = testFileForQueries.ExtractColumns("engine.key bindings", bindingColumns);
+
+	// Hashing tests, the archive copy of engine.json is used for the changes as archive entries are never saved back
+	JsonFile testFileForHashing(contentArchive, "content/engine.json");
+	testFileForHashing.EnableHashing();
+	testFileForQueries.EnableHashing();
+	uint64_t windowHashTest = testFileForHashing.HashOf("engine.window");
+	bool equalsTest = testFileForHashing.Equals(testFileForQueries, "engine.window");
+	testFileForHashing.Set<int>("engine.window.scalar.x", 3);
+	bool notEqualsTest = testFileForHashing.Equals(testFileForQueries, "engine.window");		// Only the hashes along engine.window.scalar are recomputed
+	bool contentStillEqualsTest = testFileForHashing.Equals(testFileForQueries, "engine.content");
+
+	// Time-sliced loading tests, a small slice unit makes the tile grid get parsed a few tiles at a time
+	JsonFile testFileForTimeSlicing;
+	testFileForTimeSlicing.BeginLoad("content/test_level.json", 256);
+	JsonFile::LoadState timeSlicedStateTest = JsonFile::LoadState::Loading;
+	int timeSlicedFramesTest = 0;
+	while (timeSlicedStateTest == JsonFile::LoadState::Loading) {
+		timeSlicedStateTest = testFileForTimeSlicing.Step(std::chrono::microseconds(50));
+		float timeSlicedProgressTest = testFileForTimeSlicing.LoadProgress();
+		timeSlicedFramesTest++;
+	}
+	int timeSlicedTileTest = testFileForTimeSlicing.Get<int>("level.tile grid.153");
+	testFileForTimeSlicing.BeginFeedLoad("content/fed_test.json");
+	testFileForTimeSlicing.Feed("{ \"fed test\": { \"int\": 1", 24);
+	JsonFile::LoadState fedStateTest = testFileForTimeSlicing.Step(std::chrono::microseconds(50));	// NeedsData, the root object hasn't been closed yet
+	testFileForTimeSlicing.Feed("0, \"array\": [1, 2, 3] } }", 25);
+	testFileForTimeSlicing.FinishFeeding();
+	fedStateTest = testFileForTimeSlicing.Step(std::chrono::microseconds(50));
+	int fedIntTest = testFileForTimeSlicing.Get<int>("fed test.int");		// 10
+
+	// Shared memory tests, the reader would normally be in another process attached by the same name
+	JsonSharedPublisher sharedPublisher("cpp-json-parser-engine");
+	testFileForQueries.PublishToSharedMemory(sharedPublisher);
+	JsonSharedDocument sharedReader("cpp-json-parser-engine");
+	std::string sharedTitleTest = sharedReader.Get<std::string>("engine.window.title");
+	size_t sharedBindingsTest = sharedReader.SizeOfObjectArray("engine.key bindings");
+	testFileForHashing.PublishToSharedMemory(sharedPublisher);
+	bool sharedRefreshTest = sharedReader.Refresh();		// Switches to version 2, the copy with the changed scalar
+	int sharedScalarTest = sharedReader.Get<int>("engine.window.scalar.x");
+
+	// Trace tests, only built with JSONFILE_ENABLE_TRACING as there would be nothing to write otherwise
+#ifdef JSONFILE_ENABLE_TRACING
+	bool traceWrittenTest = JsonTrace::WriteChromeTrace("json_trace.json");
+#endif
+
+	// Out-of-core tests, the level is built in a scratch file and kept to about 1 MB resident
+	JsonFile testFileForOutOfCore;
+	testFileForOutOfCore.EnableOutOfCore("test_level.arena", 1 << 20, (size_t)1 << 30);
+	testFileForOutOfCore.LoadFromArchive(contentArchive, "content/test_level.json");
+	int outOfCoreTileTest = testFileForOutOfCore.Get<int>("level.tile grid.153");
+	testFileForOutOfCore.Set<int>("level.tile grid.153", outOfCoreTileTest + 1);
+	testFileForOutOfCore.TrimResidentMemory();
+	size_t outOfCoreMemoryTest = testFileForOutOfCore.MemoryUsage();
+
 	// Close the program
 	return 0;
 }
\ No newline at end of file
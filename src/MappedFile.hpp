@@ -0,0 +1,134 @@
+#ifndef CPP_JSON_PARSER_MAPPEDFILE_HPP_
+#define CPP_JSON_PARSER_MAPPEDFILE_HPP_
+
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only memory mapping of a whole file, the mapping is released when the MappedFile is closed or destroyed
+class MappedFile {
+public:
+	// Constructors & Deconstructors
+	MappedFile(void) {}
+	~MappedFile() {
+		Close();
+	}
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const std::string& fileName) {
+		Close();
+#ifdef _WIN32
+		fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE) {
+			std::cout << "MappedFile.hpp >>>> File: " << fileName << " could not be opened" << std::endl;
+			return false;
+		}
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize)) {
+			std::cout << "MappedFile.hpp >>>> File: " << fileName << " could not be sized" << std::endl;
+			Close();
+			return false;
+		}
+		mappedSize = (size_t)fileSize.QuadPart;
+		if (mappedSize > 0) {
+			mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mappingHandle == nullptr) {
+				std::cout << "MappedFile.hpp >>>> File: " << fileName << " could not be mapped" << std::endl;
+				Close();
+				return false;
+			}
+			mappedData = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+		}
+#else
+		fileDescriptor = open(fileName.c_str(), O_RDONLY);
+		if (fileDescriptor < 0) {
+			std::cout << "MappedFile.hpp >>>> File: " << fileName << " could not be opened" << std::endl;
+			return false;
+		}
+		struct stat fileStatus;
+		if (fstat(fileDescriptor, &fileStatus) != 0) {
+			std::cout << "MappedFile.hpp >>>> File: " << fileName << " could not be sized" << std::endl;
+			Close();
+			return false;
+		}
+		mappedSize = (size_t)fileStatus.st_size;
+		if (mappedSize > 0) {
+			void* mapping = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+			mappedData = (mapping != MAP_FAILED) ? static_cast<const char*>(mapping) : nullptr;
+		}
+#endif
+		if (mappedSize > 0 && mappedData == nullptr) {
+			std::cout << "MappedFile.hpp >>>> File: " << fileName << " could not be mapped" << std::endl;
+			Close();
+			return false;
+		}
+		return true;
+	}
+	void Close(void) {
+#ifdef _WIN32
+		if (mappedData != nullptr) {
+			UnmapViewOfFile(mappedData);
+		}
+		if (mappingHandle != nullptr) {
+			CloseHandle(mappingHandle);
+			mappingHandle = nullptr;
+		}
+		if (fileHandle != INVALID_HANDLE_VALUE) {
+			CloseHandle(fileHandle);
+			fileHandle = INVALID_HANDLE_VALUE;
+		}
+#else
+		if (mappedData != nullptr) {
+			munmap(const_cast<char*>(mappedData), mappedSize);
+		}
+		if (fileDescriptor >= 0) {
+			close(fileDescriptor);
+			fileDescriptor = -1;
+		}
+#endif
+		mappedData = nullptr;
+		mappedSize = 0;
+	}
+
+	// Accessors
+	const bool IsOpen(void) const {
+#ifdef _WIN32
+		return fileHandle != INVALID_HANDLE_VALUE;
+#else
+		return fileDescriptor >= 0;
+#endif
+	}
+	const char* Data(void) const {
+		return mappedData;
+	}
+	const size_t Size(void) const {
+		return mappedSize;
+	}
+
+private:
+#ifdef _WIN32
+	HANDLE fileHandle = INVALID_HANDLE_VALUE;
+	HANDLE mappingHandle = nullptr;
+#else
+	int fileDescriptor = -1;
+#endif
+	const char* mappedData = nullptr;
+	size_t mappedSize = 0;
+};
+
+#endif
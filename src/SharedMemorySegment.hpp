@@ -0,0 +1,166 @@
+#ifndef CPP_JSON_PARSER_SHAREDMEMORYSEGMENT_HPP_
+#define CPP_JSON_PARSER_SHAREDMEMORYSEGMENT_HPP_
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Named shared memory mapping, POSIX shm_open() segments or Windows pagefile-backed file mappings.
+// Closing a segment only drops this process's mapping, on POSIX the name stays until Remove() is called and on Windows until every handle is closed
+class SharedMemorySegment {
+public:
+	// Constructors & Deconstructors
+	SharedMemorySegment(void) {}
+	~SharedMemorySegment() {
+		Close();
+	}
+	SharedMemorySegment(const SharedMemorySegment&) = delete;
+	SharedMemorySegment& operator=(const SharedMemorySegment&) = delete;
+
+	// Creates the segment with size zeroed bytes mapped read-write. An existing segment of the same name is never resized in place, since that would
+	// pull pages out from under anyone who has it mapped; on POSIX its name is unlinked first, on Windows the create fails
+	bool Create(const std::string& segmentName, const size_t& size) {
+		Close();
+#ifdef _WIN32
+		const uint64_t mappingSize = size;
+		mappingHandle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)(mappingSize >> 32), (DWORD)(mappingSize & 0xFFFFFFFF), SegmentPath(segmentName).c_str());
+		if (mappingHandle == nullptr) {
+			std::cout << "SharedMemorySegment.hpp >>>> Segment: " << segmentName << " could not be created" << std::endl;
+			return false;
+		}
+		if (GetLastError() == ERROR_ALREADY_EXISTS) {
+			std::cout << "SharedMemorySegment.hpp >>>> Segment: " << segmentName << " already exists" << std::endl;
+			Close();
+			return false;
+		}
+		mappedData = static_cast<char*>(MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, size));
+#else
+		Remove(segmentName);	// Anyone still mapping the old segment keeps it, unnamed and untouched
+		const int fileDescriptor = shm_open(SegmentPath(segmentName).c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+		if (fileDescriptor < 0) {
+			std::cout << "SharedMemorySegment.hpp >>>> Segment: " << segmentName << " could not be created" << std::endl;
+			return false;
+		}
+		if (ftruncate(fileDescriptor, (off_t)size) != 0) {
+			std::cout << "SharedMemorySegment.hpp >>>> Segment: " << segmentName << " could not be sized" << std::endl;
+			close(fileDescriptor);
+			Remove(segmentName);
+			return false;
+		}
+		void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+		close(fileDescriptor);	// The mapping keeps the segment alive on its own
+		mappedData = (mapping != MAP_FAILED) ? static_cast<char*>(mapping) : nullptr;
+#endif
+		if (mappedData == nullptr) {
+			std::cout << "SharedMemorySegment.hpp >>>> Segment: " << segmentName << " could not be mapped" << std::endl;
+			Close();
+			return false;
+		}
+		mappedSize = size;
+		return true;
+	}
+	// Maps an existing segment, whole, read-only unless isWritable is set
+	bool Open(const std::string& segmentName, const bool& isWritable) {
+		Close();
+#ifdef _WIN32
+		mappingHandle = OpenFileMappingA(isWritable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, FALSE, SegmentPath(segmentName).c_str());
+		if (mappingHandle == nullptr) {
+			return false;
+		}
+		mappedData = static_cast<char*>(MapViewOfFile(mappingHandle, isWritable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, 0));
+		if (mappedData != nullptr) {
+			MEMORY_BASIC_INFORMATION regionInfo;
+			mappedSize = (VirtualQuery(mappedData, &regionInfo, sizeof(regionInfo)) != 0) ? (size_t)regionInfo.RegionSize : 0;
+		}
+#else
+		const int fileDescriptor = shm_open(SegmentPath(segmentName).c_str(), isWritable ? O_RDWR : O_RDONLY, 0);
+		if (fileDescriptor < 0) {
+			return false;
+		}
+		struct stat segmentStatus;
+		if (fstat(fileDescriptor, &segmentStatus) != 0 || segmentStatus.st_size <= 0) {
+			close(fileDescriptor);
+			return false;
+		}
+		mappedSize = (size_t)segmentStatus.st_size;
+		void* mapping = mmap(nullptr, mappedSize, isWritable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fileDescriptor, 0);
+		close(fileDescriptor);
+		mappedData = (mapping != MAP_FAILED) ? static_cast<char*>(mapping) : nullptr;
+#endif
+		if (mappedData == nullptr) {
+			std::cout << "SharedMemorySegment.hpp >>>> Segment: " << segmentName << " could not be mapped" << std::endl;
+			Close();
+			return false;
+		}
+		return true;
+	}
+	void Close(void) {
+#ifdef _WIN32
+		if (mappedData != nullptr) {
+			UnmapViewOfFile(mappedData);
+		}
+		if (mappingHandle != nullptr) {
+			CloseHandle(mappingHandle);
+			mappingHandle = nullptr;
+		}
+#else
+		if (mappedData != nullptr) {
+			munmap(mappedData, mappedSize);
+		}
+#endif
+		mappedData = nullptr;
+		mappedSize = 0;
+	}
+	// Removes the segment's name so nothing new can open it, existing mappings stay valid. Windows names go away with their last handle
+	static void Remove(const std::string& segmentName) {
+#ifndef _WIN32
+		shm_unlink(SegmentPath(segmentName).c_str());
+#else
+		(void)segmentName;
+#endif
+	}
+
+	// Accessors
+	const bool IsOpen(void) const {
+		return mappedData != nullptr;
+	}
+	char* Data(void) const {
+		return mappedData;
+	}
+	const size_t Size(void) const {
+		return mappedSize;
+	}
+
+private:
+#ifdef _WIN32
+	HANDLE mappingHandle = nullptr;
+#endif
+	char* mappedData = nullptr;
+	size_t mappedSize = 0;
+
+	// POSIX names need a single leading slash, Windows names are kept to this session
+	static std::string SegmentPath(const std::string& segmentName) {
+#ifdef _WIN32
+		return "Local\\" + segmentName;
+#else
+		return "/" + segmentName;
+#endif
+	}
+};
+
+#endif
@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "rapidjson/document.h"
+#include <rapidjson/error/en.h>
+#include "JsonArchive.hpp"
+
+// Bundles every .json file under a content folder into a single JsonArchive.
+// Usage: cpp-json-packer <content folder> <output archive>
+// Entries are named by their path relative to the content folder's parent, e.g. "content/engine.json", so they match the loose file paths.
+int main(int argc, char* argv[]) {
+	if (argc != 3) {
+		std::cout << "ContentPacker.cpp >>>> Usage: cpp-json-packer <content folder> <output archive>" << std::endl;
+		return 1;
+	}
+	const std::filesystem::path contentFolder = std::filesystem::path(argv[1]).lexically_normal();
+	const std::filesystem::path archiveName = argv[2];
+	if (!std::filesystem::is_directory(contentFolder)) {
+		std::cout << "ContentPacker.cpp >>>> " << contentFolder.string() << " is not a folder" << std::endl;
+		return 1;
+	}
+	const std::filesystem::path namePrefix = contentFolder.has_filename() ? contentFolder.filename() : contentFolder.parent_path().filename();
+
+	std::vector<std::pair<std::string, std::string>> entries;
+	for (const std::filesystem::directory_entry& contentFile : std::filesystem::recursive_directory_iterator(contentFolder)) {
+		if (!contentFile.is_regular_file() || contentFile.path().extension() != ".json") {
+			continue;
+		}
+		std::ifstream fileStream(contentFile.path(), std::ios::binary);
+		std::stringstream fileContents;
+		fileContents << fileStream.rdbuf();
+		std::string jsonText = fileContents.str();
+
+		// Refuse to pack broken content, it's far easier to find here than at startup
+		rapidjson::Document jsonDocument;
+		jsonDocument.Parse(jsonText.c_str(), jsonText.size());
+		if (jsonDocument.HasParseError()) {
+			std::cout << "ContentPacker.cpp >>>> File: " << contentFile.path().string() << " was not packed" << std::endl;
+			std::cout << "ContentPacker.cpp >>>> Parser Errors: " << rapidjson::GetParseError_En(jsonDocument.GetParseError()) << " at offset " << jsonDocument.GetErrorOffset() << std::endl;
+			return 1;
+		}
+
+		const std::string entryName = (namePrefix / std::filesystem::relative(contentFile.path(), contentFolder)).generic_string();
+		entries.push_back(std::make_pair(entryName, std::move(jsonText)));
+	}
+
+	// Sort the entries so the archive is reproducible regardless of directory iteration order
+	std::sort(entries.begin(), entries.end());
+	if (!JsonArchive::Write(archiveName.string(), entries)) {
+		return 1;
+	}
+	std::cout << "ContentPacker.cpp >>>> Packed " << entries.size() << " files into " << archiveName.string() << std::endl;
+	return 0;
+}